@@ -0,0 +1,82 @@
+/*
+This file is part of BGSLibrary.
+
+BGSLibrary is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+BGSLibrary is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BGSParams.h"
+
+#include "pl/BackgroundSubtractorSuBSENSE.h"
+
+FrameDifferenceParams::FrameDifferenceParams() :
+  enableThreshold(true), threshold(15), showOutput(false)
+{
+}
+
+DPGrimsonGMMParams::DPGrimsonGMMParams() :
+  threshold(9.0), alpha(0.01), gaussians(3), showOutput(false)
+{
+}
+
+DPZivkovicAGMMParams::DPZivkovicAGMMParams() :
+  threshold(25.0f), alpha(0.001f), gaussians(3), nThreads(1), showOutput(false)
+{
+}
+
+DPWrenGAParams::DPWrenGAParams() :
+  threshold(12.25f), alpha(0.005f), learningFrames(30), fixedPoint(false), showOutput(false)
+{
+}
+
+DPTextureParams::DPTextureParams() :
+  showOutput(false)
+{
+}
+
+LBAdaptiveSOMParams::LBAdaptiveSOMParams() :
+  sensitivity(75), trainingSensitivity(245), learningRate(62),
+  trainingLearningRate(255), trainingSteps(55), showOutput(false)
+{
+}
+
+VuMeterParams::VuMeterParams() :
+  enableFilter(true), binSize(8), alpha(0.995), threshold(0.03),
+  showOutput(false)
+{
+}
+
+KDEParams::KDEParams() :
+  framesToLearn(10), SequenceLength(50), TimeWindowSize(100),
+  SDEstimationFlag(1), lUseColorRatiosFlag(1), PixelMajorFlag(0),
+  th(10e-8), alpha(0.3), nThreads(1),
+  showOutput(false)
+{
+}
+
+SigmaDeltaParams::SigmaDeltaParams() :
+  ampFactor(1), minVar(15), maxVar(255), showOutput(false)
+{
+}
+
+SuBSENSEParams::SuBSENSEParams() :
+  fRelLBSPThreshold(BGSSUBSENSE_DEFAULT_LBSP_REL_SIMILARITY_THRESHOLD),
+  nDescDistThresholdOffset(BGSSUBSENSE_DEFAULT_DESC_DIST_THRESHOLD_OFFSET),
+  nMinColorDistThreshold(BGSSUBSENSE_DEFAULT_MIN_COLOR_DIST_THRESHOLD),
+  nBGSamples(BGSSUBSENSE_DEFAULT_NB_BG_SAMPLES),
+  nRequiredBGSamples(BGSSUBSENSE_DEFAULT_REQUIRED_NB_BG_SAMPLES),
+  nSamplesForMovingAvgs(BGSSUBSENSE_DEFAULT_N_SAMPLES_FOR_MV_AVGS),
+  nThreads(BGSSUBSENSE_DEFAULT_NB_THREADS),
+  nSeed(BGSSUBSENSE_DEFAULT_SEED),
+  showOutput(false)
+{
+}
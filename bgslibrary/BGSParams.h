@@ -0,0 +1,153 @@
+/*
+This file is part of BGSLibrary.
+
+BGSLibrary is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+BGSLibrary is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+  Parameters of the background subtraction algorithms. They are given once to
+  the constructor of an algorithm, instead of being read from ./config/*.xml.
+  The default values are the ones used when no configuration file exists.
+*/
+
+struct FrameDifferenceParams
+{
+  bool enableThreshold;
+  int threshold;
+  bool showOutput;
+
+  FrameDifferenceParams();
+};
+
+struct DPGrimsonGMMParams
+{
+  double threshold;
+  double alpha;
+  int gaussians;
+  bool showOutput;
+
+  DPGrimsonGMMParams();
+};
+
+struct DPZivkovicAGMMParams
+{
+  double threshold;
+  double alpha;
+  int gaussians;
+  size_t nThreads;
+  bool showOutput;
+
+  DPZivkovicAGMMParams();
+};
+
+struct DPWrenGAParams
+{
+  double threshold;
+  double alpha;
+  int learningFrames;
+  bool fixedPoint;
+  bool showOutput;
+
+  DPWrenGAParams();
+};
+
+struct DPTextureParams
+{
+  bool showOutput;
+
+  DPTextureParams();
+};
+
+struct LBAdaptiveSOMParams
+{
+  int sensitivity;
+  int trainingSensitivity;
+  int learningRate;
+  int trainingLearningRate;
+  int trainingSteps;
+  bool showOutput;
+
+  LBAdaptiveSOMParams();
+};
+
+struct VuMeterParams
+{
+  bool enableFilter;
+  int binSize;
+  double alpha;
+  double threshold;
+  bool showOutput;
+
+  VuMeterParams();
+};
+
+struct KDEParams
+{
+  int framesToLearn;
+  int SequenceLength;
+  int TimeWindowSize;
+  int SDEstimationFlag;
+  int lUseColorRatiosFlag;
+  int PixelMajorFlag;
+  double th;
+  double alpha;
+  size_t nThreads;
+  bool showOutput;
+
+  KDEParams();
+};
+
+struct SigmaDeltaParams
+{
+  unsigned int ampFactor;
+  unsigned int minVar;
+  unsigned int maxVar;
+  bool showOutput;
+
+  SigmaDeltaParams();
+};
+
+struct SuBSENSEParams
+{
+  float fRelLBSPThreshold;
+  size_t nDescDistThresholdOffset;
+  size_t nMinColorDistThreshold;
+  size_t nBGSamples;
+  size_t nRequiredBGSamples;
+  size_t nSamplesForMovingAvgs;
+  size_t nThreads;
+  uint32_t nSeed;
+  bool showOutput;
+
+  SuBSENSEParams();
+};
+
+/* Parameters of every algorithm, only the ones of the selected one are used. */
+struct BGSParams
+{
+  FrameDifferenceParams frameDifference;
+  DPGrimsonGMMParams grimsonGMM;
+  DPZivkovicAGMMParams zivkovicAGMM;
+  DPWrenGAParams wrenGA;
+  DPTextureParams texture;
+  LBAdaptiveSOMParams adaptiveSOM;
+  VuMeterParams vuMeter;
+  KDEParams kde;
+  SigmaDeltaParams sigmaDelta;
+  SuBSENSEParams subsense;
+};
@@ -16,14 +16,19 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "FrameDifferenceBGS.h"
 
-FrameDifferenceBGS::FrameDifferenceBGS() : firstTime(true), enableThreshold(true), threshold(15), showOutput(true)
+FrameDifferenceBGS::FrameDifferenceBGS(const FrameDifferenceParams& parameters) :
+  firstTime(true), enableThreshold(parameters.enableThreshold), threshold(parameters.threshold), showOutput(parameters.showOutput)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "FrameDifferenceBGS()" << std::endl;
+#endif
 }
 
 FrameDifferenceBGS::~FrameDifferenceBGS()
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "~FrameDifferenceBGS()" << std::endl;
+#endif
 }
 
 void FrameDifferenceBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -31,53 +36,40 @@ void FrameDifferenceBGS::process(const cv::Mat &img_input, cv::Mat &img_output,
   if(img_input.empty())
     return;
 
-  loadConfig();
+  img_foreground.create(img_input.size(), CV_8UC1);
 
-  if(firstTime)
-    saveConfig();
-
-  if(img_input_prev.empty())
-  {
-    img_input.copyTo(img_input_prev);
+  if(!processMask(img_input, img_foreground))
     return;
-  }
-
-  cv::absdiff(img_input_prev, img_input, img_foreground);
-
-  if(img_foreground.channels() == 3)
-    cv::cvtColor(img_foreground, img_foreground, CV_BGR2GRAY);
-
-  if(enableThreshold)
-    cv::threshold(img_foreground, img_foreground, threshold, 255, cv::THRESH_BINARY);
 
+#ifndef LABGEN_HEADLESS
   if(showOutput)
     cv::imshow("Frame Difference", img_foreground);
+#endif
 
   img_foreground.copyTo(img_output);
-
-  img_input.copyTo(img_input_prev);
-
-  firstTime = false;
 }
 
-void FrameDifferenceBGS::saveConfig()
+bool FrameDifferenceBGS::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
 {
-  CvFileStorage* fs = cvOpenFileStorage("./config/FrameDifferenceBGS.xml", 0, CV_STORAGE_WRITE);
+  if(img_input_prev.empty())
+  {
+    img_input.copyTo(img_input_prev);
+    return false;
+  }
 
-  cvWriteInt(fs, "enableThreshold", enableThreshold);
-  cvWriteInt(fs, "threshold", threshold);
-  cvWriteInt(fs, "showOutput", showOutput);
+  if(img_input.channels() == 3)
+  {
+    cv::absdiff(img_input_prev, img_input, img_difference);
+    cv::cvtColor(img_difference, img_mask, CV_BGR2GRAY);
+  }
+  else
+    cv::absdiff(img_input_prev, img_input, img_mask);
 
-  cvReleaseFileStorage(&fs);
-}
+  if(enableThreshold)
+    cv::threshold(img_mask, img_mask, threshold, 255, cv::THRESH_BINARY);
 
-void FrameDifferenceBGS::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/FrameDifferenceBGS.xml", 0, CV_STORAGE_READ);
-  
-  enableThreshold = cvReadIntByName(fs, 0, "enableThreshold", true);
-  threshold = cvReadIntByName(fs, 0, "threshold", 15);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
+  img_input.copyTo(img_input_prev);
 
-  cvReleaseFileStorage(&fs);
+  firstTime = false;
+  return true;
 }
\ No newline at end of file
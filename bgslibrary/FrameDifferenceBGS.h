@@ -21,24 +21,23 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "IBGS.h"
+#include "BGSParams.h"
 
 class FrameDifferenceBGS : public IBGS
 {
 private:
   bool firstTime;
   cv::Mat img_input_prev;
+  cv::Mat img_difference;
   cv::Mat img_foreground;
   bool enableThreshold;
   int threshold;
   bool showOutput;
 
 public:
-  FrameDifferenceBGS();
+  FrameDifferenceBGS(const FrameDifferenceParams& parameters = FrameDifferenceParams());
   ~FrameDifferenceBGS();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
-
-private:
-  void saveConfig();
-  void loadConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
\ No newline at end of file
@@ -19,18 +19,23 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc_c.h>
 #include <opencv2/imgproc/types_c.h>
+#ifndef LABGEN_HEADLESS
 #include <opencv2/highgui/highgui_c.h>
+#endif
 
 class IBGS
 {
 public:
   virtual void process(const cv::Mat &img_input, cv::Mat &img_foreground, cv::Mat &img_background) = 0;
+  /*
+    Zero-copy entry point: img_input is only read during the call, and the foreground
+    is written into img_mask, a continuous CV_8UC1 matrix of the size of the input
+    allocated once by the caller. Nothing is allocated per frame. Returns false, with
+    img_mask left untouched, as long as the model cannot produce a mask.
+  */
+  virtual bool processMask(const cv::Mat &img_input, cv::Mat &img_mask) = 0;
   /*virtual void process(const cv::Mat &img_input, cv::Mat &img_foreground){
     process(img_input, img_foreground, cv::Mat());
   }*/
   virtual ~IBGS(){}
-
-private:
-  virtual void saveConfig() = 0;
-  virtual void loadConfig() = 0;
 };
@@ -0,0 +1,142 @@
+/*
+This file is part of BGSLibrary.
+
+BGSLibrary is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+BGSLibrary is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t threads) :
+  threads(threads > 0 ? threads : 1), task(0), count(0), next(0), generation(0), pending(0), stopping(false)
+{
+  for(size_t i = 1; i < this->threads; ++i)
+    workers.push_back(std::thread(&WorkerPool::work, this));
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  startCondition.notify_all();
+
+  for(size_t i = 0; i < workers.size(); ++i)
+    workers[i].join();
+}
+
+size_t WorkerPool::size() const
+{
+  return threads;
+}
+
+void WorkerPool::parallelFor(size_t count, const Task& task)
+{
+  if(workers.empty() || count < 2)
+  {
+    for(size_t i = 0; i < count; ++i)
+      task(i);
+
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->task = &task;
+    this->count = count;
+    next = 0;
+    ++generation;
+    pending = workers.size();
+    error = std::exception_ptr();
+  }
+
+  startCondition.notify_all();
+  run();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  while(pending > 0)
+    doneCondition.wait(lock);
+
+  this->task = 0;
+
+  if(error)
+    std::rethrow_exception(error);
+}
+
+void WorkerPool::parallelForRows(size_t rows, const RangeTask& task)
+{
+  // A few bands per thread balance the load.
+  size_t bands = threads > 1 ? 4*threads : 1;
+  if(bands > rows)
+    bands = rows;
+
+  if(bands <= 1)
+  {
+    task(0, rows);
+    return;
+  }
+
+  parallelFor(bands, [&](size_t band)
+  {
+    task(band*rows/bands, (band+1)*rows/bands);
+  });
+}
+
+void WorkerPool::work()
+{
+  size_t lastGeneration = 0;
+
+  for(;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while(!stopping && generation == lastGeneration)
+        startCondition.wait(lock);
+
+      if(stopping)
+        return;
+
+      lastGeneration = generation;
+    }
+
+    run();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      if(--pending == 0)
+        doneCondition.notify_one();
+    }
+  }
+}
+
+void WorkerPool::run()
+{
+  for(size_t i = next++; i < count; i = next++)
+  {
+    try
+    {
+      (*task)(i);
+    }
+    catch(...)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      if(!error)
+        error = std::current_exception();
+    }
+  }
+}
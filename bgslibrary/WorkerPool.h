@@ -0,0 +1,77 @@
+/*
+This file is part of BGSLibrary.
+
+BGSLibrary is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+BGSLibrary is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  Fixed set of workers running parallel loops over independent items, such as
+  the horizontal bands of a frame. The items are handed out one at a time, and
+  the calling thread takes part in the loop, so a pool of one thread runs
+  everything serially without any thread.
+
+  LaBGen has the same pool in include/labgen/ThreadPool.hpp, but BGSLibrary
+  is built as its own library below LaBGen and does not see its headers, so
+  it keeps this copy.
+*/
+class WorkerPool
+{
+public:
+  typedef std::function<void(size_t)> Task;
+  typedef std::function<void(size_t, size_t)> RangeTask;
+
+private:
+  size_t threads;
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable startCondition;
+  std::condition_variable doneCondition;
+  const Task* task;
+  size_t count;
+  std::atomic<size_t> next;
+  size_t generation;
+  size_t pending;
+  bool stopping;
+  std::exception_ptr error;
+
+public:
+  explicit WorkerPool(size_t threads = 1);
+  ~WorkerPool();
+
+  size_t size() const;
+
+  // runs task(i) for every i in [0, count) and returns once all are done
+  void parallelFor(size_t count, const Task& task);
+
+  // splits the rows [0, rows) into a few bands per thread, or a single band
+  // with one thread, and runs task(first, end) for every band
+  void parallelForRows(size_t rows, const RangeTask& task);
+
+private:
+  WorkerPool(const WorkerPool&);
+  WorkerPool& operator=(const WorkerPool&);
+
+  void work();
+  void run();
+};
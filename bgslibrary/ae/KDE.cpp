@@ -16,18 +16,24 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "KDE.h"
 
-KDE::KDE() : SequenceLength(50), TimeWindowSize(100), SDEstimationFlag(1), lUseColorRatiosFlag(1),
-  th(10e-8), alpha(0.3), framesToLearn(10), frameNumber(0), firstTime(true), showOutput(true)
+KDE::KDE(const KDEParams& parameters) : SequenceLength(parameters.SequenceLength), TimeWindowSize(parameters.TimeWindowSize),
+  SDEstimationFlag(parameters.SDEstimationFlag), lUseColorRatiosFlag(parameters.lUseColorRatiosFlag),
+  PixelMajorFlag(parameters.PixelMajorFlag),
+  th(parameters.th), alpha(parameters.alpha), framesToLearn(parameters.framesToLearn), frameNumber(0), firstTime(true),
+  showOutput(parameters.showOutput)
 {
-  p = new NPBGSubtractor;
+  p = new NPBGSubtractor(parameters.nThreads);
+#ifndef LABGEN_HEADLESS
   std::cout << "KDE()" << std::endl;
+#endif
 }
 
 KDE::~KDE()
 {
-  delete FGImage;
   delete p;
+#ifndef LABGEN_HEADLESS
   std::cout << "~KDE()" << std::endl;
+#endif
 }
 
 void KDE::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -35,8 +41,21 @@ void KDE::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bg
   if(img_input.empty())
     return;
 
-  loadConfig();
+  img_foreground.create(img_input.size(), CV_8UC1);
 
+  if(!processMask(img_input, img_foreground))
+    return;
+
+#ifndef LABGEN_HEADLESS
+  if(showOutput)
+    cv::imshow("KDE", img_foreground);
+#endif
+
+  img_foreground.copyTo(img_output);
+}
+
+bool KDE::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
+{
   if(firstTime)
   {
     rows = img_input.size().height;
@@ -48,81 +67,44 @@ void KDE::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bg
     // this rate will affect how fast the model adapt.
     // SDEstimationFlag: True means to estimate suitable kernel bandwidth to each pixel, False uses a default value.
     // lUseColorRatiosFlag: True means use normalized RGB for color (recommended.)
-    p->Intialize(rows,cols,color_channels,SequenceLength,TimeWindowSize,SDEstimationFlag,lUseColorRatiosFlag);
+    // PixelMajorFlag: True means store the samples of each pixel contiguously. Same results, faster when many pixels need many samples.
+    p->Intialize(rows,cols,color_channels,SequenceLength,TimeWindowSize,SDEstimationFlag,lUseColorRatiosFlag,PixelMajorFlag);
     // th: 0-1 is the probability threshold for a pixel to be a foregroud. typically make it small as 10e-8. the smaller the value the less false positive and more false negative.
     // alpha: 0-1, for color. typically set to 0.3. this affect shadow suppression.
     p->SetThresholds(th,alpha);
 
-    FGImage = new unsigned char[rows*cols];
     //FilteredFGImage = new unsigned char[rows*cols];
     FilteredFGImage = 0;
     DisplayBuffers = 0;
 
-    img_foreground = cv::Mat::zeros(rows,cols,CV_8UC1);
-
     frameNumber = 0;
-    saveConfig();
     firstTime = false;
   }
 
   // Stores the first N frames to build the background model
   if(frameNumber < framesToLearn)
   {
-    p->AddFrame(img_input.data);
+    // AddFrame converts the frame in place, so it works on a copy
+    img_input.copyTo(img_learning);
+    p->AddFrame(img_learning.data);
     frameNumber++;
-    return;
+    return false;
   }
 
   // Build the background model with first 10 frames
   if(frameNumber == framesToLearn)
   {
     p->Estimation();
+    img_learning.release();
     frameNumber++;
   }
 
   // Now, we can subtract the background
-  ((NPBGSubtractor *)p)->NBBGSubtraction(img_input.data,FGImage,FilteredFGImage,DisplayBuffers);
+  ((NPBGSubtractor *)p)->NBBGSubtraction(img_input.data,img_mask.data,FilteredFGImage,DisplayBuffers);
   
   // At each frame also you can call the update function to adapt the bg
   // here you pass a mask where pixels with true value will be masked out of the update.
-  ((NPBGSubtractor *)p)->Update(FGImage);
-
-  img_foreground.data = FGImage;
+  ((NPBGSubtractor *)p)->Update(img_mask.data);
 
-  if(showOutput)
-    cv::imshow("KDE", img_foreground);
-
-  img_foreground.copyTo(img_output);
-}
-
-void KDE::saveConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/KDE.xml", 0, CV_STORAGE_WRITE);
-
-  cvWriteInt(fs, "framesToLearn", framesToLearn);
-  cvWriteInt(fs, "SequenceLength", SequenceLength);
-  cvWriteInt(fs, "TimeWindowSize", TimeWindowSize);
-  cvWriteInt(fs, "SDEstimationFlag", SDEstimationFlag);
-  cvWriteInt(fs, "lUseColorRatiosFlag", lUseColorRatiosFlag);
-  cvWriteReal(fs, "th", th);
-  cvWriteReal(fs, "alpha", alpha);
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
-}
-
-void KDE::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/KDE.xml", 0, CV_STORAGE_READ);
-  
-  framesToLearn = cvReadIntByName(fs, 0, "framesToLearn", 10);
-  SequenceLength = cvReadIntByName(fs, 0, "SequenceLength", 50);
-  TimeWindowSize = cvReadIntByName(fs, 0, "TimeWindowSize", 100);
-  SDEstimationFlag = cvReadIntByName(fs, 0, "SDEstimationFlag", 1);
-  lUseColorRatiosFlag = cvReadIntByName(fs, 0, "lUseColorRatiosFlag", 1);
-  th = cvReadRealByName(fs, 0, "th", 10e-8);
-  alpha = cvReadRealByName(fs, 0, "alpha", 0.3);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
-
-  cvReleaseFileStorage(&fs);
+  return true;
 }
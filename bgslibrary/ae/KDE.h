@@ -22,6 +22,7 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "NPBGSubtractor.h"
 #include "../IBGS.h"
+#include "../BGSParams.h"
 
 class KDE : public IBGS
 {
@@ -34,6 +35,7 @@ private:
   int TimeWindowSize;
   int SDEstimationFlag;
   int lUseColorRatiosFlag;
+  int PixelMajorFlag;
   double th;
   double alpha;
   int framesToLearn;
@@ -42,17 +44,14 @@ private:
   bool showOutput;
 
   cv::Mat img_foreground;
-  unsigned char *FGImage;
+  cv::Mat img_learning;
   unsigned char *FilteredFGImage;
   unsigned char **DisplayBuffers;
 
 public:
-  KDE();
+  KDE(const KDEParams& parameters = KDEParams());
   ~KDE();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
-  
-private:
-  void saveConfig();
-  void loadConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
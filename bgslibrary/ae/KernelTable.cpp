@@ -53,19 +53,25 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 KernelLUTable::KernelLUTable()
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "KernelLUTable()" << std::endl;
+#endif
 }
 
 KernelLUTable::~KernelLUTable()
 {
-  delete kerneltable;
-  delete kernelsums;
+  delete[] kerneltable;
+  delete[] kernelsums;
+#ifndef LABGEN_HEADLESS
   std::cout << "~KernelLUTable()" << std::endl;
+#endif
 }
 
 KernelLUTable::KernelLUTable(int KernelHalfWidth, double Segmamin, double Segmamax, int Segmabins)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "KernelLUTable()" << std::endl;
+#endif
 
   double C1,C2,v,segma,sum;
   int bin,b;
@@ -78,7 +84,7 @@ KernelLUTable::KernelLUTable(int KernelHalfWidth, double Segmamin, double Segmam
   // Generate the Kernel
 
   // allocate memory for the Kernal Table
-  kerneltable = new double[segmabins*(2*KernelHalfWidth+1)];
+  kerneltable = new float[segmabins*(2*KernelHalfWidth+1)];
   kernelsums = new double[segmabins];
 
   double segmastep = (maxsegma - minsegma) / segmabins;
@@ -96,8 +102,6 @@ KernelLUTable::KernelLUTable(int KernelHalfWidth, double Segmamin, double Segmam
     {
       y = x/1.0;
       v = C1*exp(C2*y*y);
-      kerneltable[b+KernelHalfWidth+x]=v;
-      kerneltable[b+KernelHalfWidth-x]=v;
       sum += 2*v;
     }
 
@@ -105,12 +109,13 @@ KernelLUTable::KernelLUTable(int KernelHalfWidth, double Segmamin, double Segmam
 
     kernelsums[bin] = sum;
 
-    // Normailization
+    // Normailization, in double precision before rounding to the table
     for(int x = 0; x <= KernelHalfWidth; x++)
     {
-      v = kerneltable[b+KernelHalfWidth+x] / sum;
-      kerneltable[b+KernelHalfWidth+x]=v;
-      kerneltable[b+KernelHalfWidth-x]=v;
+      y = x/1.0;
+      v = C1*exp(C2*y*y) / sum;
+      kerneltable[b+KernelHalfWidth+x]=(float) v;
+      kerneltable[b+KernelHalfWidth-x]=(float) v;
     }
   }
 }
@@ -58,7 +58,8 @@ public:
   double maxsegma;
   int segmabins;
   int tablehalfwidth;
-  double *kerneltable;
+  // single precision, so that the table of all the bins fits in L2 cache
+  float *kerneltable;
   double *kernelsums;
 
 public:
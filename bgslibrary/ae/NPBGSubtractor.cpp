@@ -55,6 +55,20 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 #include <math.h>
 #include <string.h>
 
+/*
+ * The kernels of the samples of a pixel are summed by blocks of NPBG_BLOCK
+ * samples (see SumKernels). Unless NPBG_NO_SIMD is defined, the lanes of the
+ * blocks are summed with SSE2. Both paths sum the lanes in the same order,
+ * so that they give the same results (see test/KDE-simd).
+ */
+#if !defined(NPBG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NPBG_SSE2
+#include <emmintrin.h>
+#endif
+
+#define NPBG_BLOCK 4
+
 //#ifdef _DEBUG
 //#undef THIS_FILE
 //static char THIS_FILE[]=__FILE__;
@@ -89,9 +103,14 @@ void BGR2SnGnRn(unsigned char * in_image,
   }
 }
 
-void UpdateDiffHist(unsigned char * image1, unsigned char * image2, DynamicMedianHistogram * pHist)
+// The pixels of the images are PixelStride bytes apart (see NPBGmodel).
+void UpdateDiffHist(unsigned char * image1,
+                    unsigned char * image2,
+                    unsigned int color_channels,
+                    unsigned int PixelStride,
+                    DynamicMedianHistogram * pHist)
 {
-  unsigned int j;
+  unsigned int j,ch,idx;
   int bin,diff;
 
   unsigned int  imagesize	= pHist->imagesize;
@@ -100,13 +119,16 @@ void UpdateDiffHist(unsigned char * image1, unsigned char * image2, DynamicMedia
 
   int histbins_1 = histbins-1;
   
-  for(j = 0; j < imagesize; j++)
+  for(j = 0, idx = 0; j < imagesize; idx += PixelStride)
   {
-    diff = (int) image1[j] - (int) image2[j];
-    diff = abs(diff);
-    // update histogram
-    bin = (diff < histbins ? diff : histbins_1);
-    pAbsDiffHist[j*histbins+bin]++;
+    for(ch = 0; ch < color_channels; ch++, j++)
+    {
+      diff = (int) image1[idx+ch] - (int) image2[idx+ch];
+      diff = abs(diff);
+      // update histogram
+      bin = (diff < histbins ? diff : histbins_1);
+      pAbsDiffHist[j*histbins+bin]++;
+    }
   }
 }
 
@@ -152,10 +174,11 @@ DynamicMedianHistogram BuildAbsDiffHist(unsigned char * pSequence,
   unsigned int cols,
   unsigned int color_channels,
   unsigned int SequenceLength,
-  unsigned int histbins)
+  unsigned int histbins,
+  unsigned int SampleStride,
+  unsigned int PixelStride)
 {
 
-  unsigned int imagesize=rows*cols*color_channels;
   unsigned int i;
 
   DynamicMedianHistogram Hist;
@@ -179,10 +202,10 @@ DynamicMedianHistogram BuildAbsDiffHist(unsigned char * pSequence,
   for(i = 1; i < SequenceLength; i++)
   {
     // find diff between frame i,i-1;
-    image1 = pSequence+(i-1)*imagesize;
-    image2 = pSequence+(i)*imagesize;
+    image1 = pSequence+(i-1)*SampleStride;
+    image2 = pSequence+(i)*SampleStride;
 
-    UpdateDiffHist(image1,image2,&Hist);
+    UpdateDiffHist(image1,image2,color_channels,PixelStride,&Hist);
   }
 
   FindHistMedians(&Hist);
@@ -244,7 +267,7 @@ void EstimateSDsFromAbsDiffHist(DynamicMedianHistogram * pAbsDiffHist,
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-NPBGSubtractor::NPBGSubtractor(){}
+NPBGSubtractor::NPBGSubtractor(unsigned int threads) : workers(threads) {}
 
 NPBGSubtractor::~NPBGSubtractor()
 {
@@ -268,7 +291,8 @@ int NPBGSubtractor::Intialize(unsigned int prows,
                               unsigned int SequenceLength,
                               unsigned int pTimeWindowSize,
                               unsigned char pSDEstimationFlag,
-                              unsigned char pUseColorRatiosFlag)
+                              unsigned char pUseColorRatiosFlag,
+                              unsigned char pPixelMajorFlag)
 {
 
   rows=prows;
@@ -285,7 +309,7 @@ int NPBGSubtractor::Intialize(unsigned int prows,
 
   UpdateSDRate = 0;
 
-  BGModel = new NPBGmodel(rows,cols,color_channels,SequenceLength,pTimeWindowSize,500);
+  BGModel = new NPBGmodel(rows,cols,color_channels,SequenceLength,pTimeWindowSize,500,pPixelMajorFlag != FALSE);
 
   Pimage1= new double[rows*cols];
   Pimage2= new double[rows*cols];
@@ -326,12 +350,13 @@ void NPBGSubtractor::Estimation()
   int Abshistbins = 20;
 
   TimeIndex=0;
+  TBCount=0;
 
   // estimate standard deviations 
 
   if(SdEstimateFlag)
   {
-    AbsDiffHist = BuildAbsDiffHist(BGModel->Sequence,rows,cols,color_channels,SampleSize,Abshistbins);
+    AbsDiffHist = BuildAbsDiffHist(BGModel->Sequence,rows,cols,color_channels,SampleSize,Abshistbins,BGModel->SampleStride,BGModel->PixelStride);
     EstimateSDsFromAbsDiffHist(&AbsDiffHist,pSDs,imagesize,SEGMAMIN,SEGMAMAX,SEGMABINS);
   }
   else
@@ -349,6 +374,16 @@ void NPBGSubtractor::Estimation()
 
 /*********************************************************************/
 
+void NPBGSubtractor::ForEachBand(const BandTask& task)
+{
+  workers.parallelForRows(rows, [&](size_t first, size_t end)
+  {
+    task((unsigned int) first*cols,(unsigned int) end*cols);
+  });
+}
+
+/*********************************************************************/
+
 void BuildImageIndex(unsigned char * Image,
                      ImageIndex * imageIndex,
                      unsigned int rows,
@@ -664,10 +699,12 @@ void NoiseFilter_o(unsigned char * Image,
 void NPBGSubtractor::SequenceBGUpdate_Pairs(unsigned char * image,
                                             unsigned char * Mask)
 {
-  unsigned int i,ic;
+  unsigned int i;
   unsigned char * pSequence 	=BGModel->Sequence;
   unsigned char * PixelQTop		=BGModel->PixelQTop;
   unsigned int Top						=BGModel->Top;
+  unsigned int SampleStride		=BGModel->SampleStride;
+  unsigned int PixelStride		=BGModel->PixelStride;
   unsigned int rate;
 
   int TemporalBufferTop						=(int) BGModel->TemporalBufferTop;
@@ -690,17 +727,6 @@ void NPBGSubtractor::SequenceBGUpdate_Pairs(unsigned char * image,
   unsigned int imagebuffersize=rows*cols*color_channels;
   unsigned int imagespatialsize=rows*cols;
 
-  unsigned char mask;
-
-  unsigned int histindex;
-  unsigned char diff;
-  unsigned char bin;
-
-  static int TBCount=0;
-
-  unsigned char * pTBbase1, * pTBbase2;
-  unsigned char * pModelbase1, * pModelbase2;
-
   rate=TimeWindowSize/SampleSize;
   rate=(rate > 2) ? rate : 2;
 
@@ -718,91 +744,105 @@ void NPBGSubtractor::SequenceBGUpdate_Pairs(unsigned char * image,
 
   if ( ((TimeIndex) % rate == 0)  && TBCount >= TemporalBufferLength )
   {
-    for(i=0,ic=0;i<imagespatialsize;i++,ic+=color_channels)
+    // the pixels are independent, so the bands are updated concurrently
+    ForEachBand([&](unsigned int first, unsigned int end)
     {
-      mask= * (pTMaskTop+i) || * (pTMaskNext+i);
+      unsigned int i,ic;
+      unsigned char mask;
 
-      if(!mask)
-      {
-        // pointer to TB pixels to be added to the model
-        pTBbase1=pTBTop+ic;
-        pTBbase2=pTBNext+ic;
+      unsigned int histindex;
+      unsigned char diff;
+      unsigned char bin;
 
-        // pointers to Model pixels to be replaced
-        pModelbase1=pSequence+PixelQTop[i]*imagebuffersize+ic;
-        pModelbase2=pSequence+((PixelQTop[i]+1)% SampleSize)*imagebuffersize+ic;
+      unsigned char * pTBbase1, * pTBbase2;
+      unsigned char * pModelbase1, * pModelbase2;
 
-        // update Deviation Histogram
-        if(SdEstimateFlag)
-        {
-          if(color_channels==1)
-          {
-            histindex=i*histbins;	
+      for(i=first,ic=first*color_channels;i<end;i++,ic+=color_channels)
+      {
+        mask= * (pTMaskTop+i) || * (pTMaskNext+i);
 
-            // add new pair from temporal buffer
-            diff=(unsigned char) abs((int) *pTBbase1 - (int) *pTBbase2);
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]++;
+        if(!mask)
+        {
+          // pointer to TB pixels to be added to the model
+          pTBbase1=pTBTop+ic;
+          pTBbase2=pTBNext+ic;
 
+          // pointers to Model pixels to be replaced
+          pModelbase1=pSequence+i*PixelStride+PixelQTop[i]*SampleStride;
+          pModelbase2=pSequence+i*PixelStride+((PixelQTop[i]+1)% SampleSize)*SampleStride;
 
-            // remove old pair from the model
-            diff=(unsigned char) abs((int) *pModelbase1-(int) *pModelbase2);
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]--;
-          }
-          else
+          // update Deviation Histogram
+          if(SdEstimateFlag)
           {
-            // color
-
-            // add new pair from temporal buffer
-            histindex=ic*histbins;	
-            diff=abs(*pTBbase1 -
-              *pTBbase2);
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]++;
-
-            histindex+=histbins;	
-            diff=abs(*(pTBbase1+1) -
-              *(pTBbase2+1));
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]++;
-
-            histindex+=histbins;	
-            diff=abs(*(pTBbase1+2) -
-              *(pTBbase2+2));
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]++;
-
-            // remove old pair from the model
-            histindex=ic*histbins;	
-
-            diff=abs(*pModelbase1-
-              *pModelbase2);
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]--;
-
-            histindex+=histbins;	
-            diff=abs(*(pModelbase1+1)-
-              *(pModelbase2+1));
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]--;
-
-            histindex+=histbins;	
-            diff=abs(*(pModelbase1+2)-
-              *(pModelbase2+2));
-            bin=(diff < histbins ? diff : histbins_1);
-            pAbsDiffHist[histindex+bin]--;
+            if(color_channels==1)
+            {
+              histindex=i*histbins;	
+
+              // add new pair from temporal buffer
+              diff=(unsigned char) abs((int) *pTBbase1 - (int) *pTBbase2);
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]++;
+
+
+              // remove old pair from the model
+              diff=(unsigned char) abs((int) *pModelbase1-(int) *pModelbase2);
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]--;
+            }
+            else
+            {
+              // color
+
+              // add new pair from temporal buffer
+              histindex=ic*histbins;	
+              diff=abs(*pTBbase1 -
+                *pTBbase2);
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]++;
+
+              histindex+=histbins;	
+              diff=abs(*(pTBbase1+1) -
+                *(pTBbase2+1));
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]++;
+
+              histindex+=histbins;	
+              diff=abs(*(pTBbase1+2) -
+                *(pTBbase2+2));
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]++;
+
+              // remove old pair from the model
+              histindex=ic*histbins;	
+
+              diff=abs(*pModelbase1-
+                *pModelbase2);
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]--;
+
+              histindex+=histbins;	
+              diff=abs(*(pModelbase1+1)-
+                *(pModelbase2+1));
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]--;
+
+              histindex+=histbins;	
+              diff=abs(*(pModelbase1+2)-
+                *(pModelbase2+2));
+              bin=(diff < histbins ? diff : histbins_1);
+              pAbsDiffHist[histindex+bin]--;
+            }
           }
-        }
 
-        // add new pair into the model
-        memcpy(pModelbase1,pTBbase1, color_channels*sizeof(unsigned char));
+          // add new pair into the model
+          memcpy(pModelbase1,pTBbase1, color_channels*sizeof(unsigned char));
 
-        memcpy(pModelbase2,pTBbase2, color_channels*sizeof(unsigned char));
+          memcpy(pModelbase2,pTBbase2, color_channels*sizeof(unsigned char));
 
-        PixelQTop[i]=(PixelQTop[i]+2) % SampleSize;
+          PixelQTop[i]=(PixelQTop[i]+2) % SampleSize;
+        }
       }
-    }
+    });
   } // end if (sampling event)
 
   // update temporal buffer
@@ -870,36 +910,250 @@ void DisplayPropabilityImageWithThresholding(double * Pimage,
 
 /*********************************************************************/
 
+// Kernels of the samples of the current pixel, centered on its value.
+struct PixelKernel
+{
+  const unsigned char *sequence;
+  unsigned int SampleStride;
+  unsigned int PixelStride;
+  const unsigned char *image;
+  const unsigned char *SDbins;
+  const float *kerneltable;
+  unsigned int kerneltablewidth;
+  int KernelHalfWidth;
+
+  // samples of the current pixel
+  const unsigned char *samples;
+
+  const float *Centered(unsigned int bin, unsigned char value) const
+  {
+    return kerneltable+bin*kerneltablewidth+KernelHalfWidth-value;
+  }
+
+  const unsigned char *Sample(unsigned int j) const
+  {
+    return samples+j*SampleStride;
+  }
+};
+
+struct GrayKernel : PixelKernel
+{
+  const float *kernel;
+
+  void SetPixel(unsigned int pixel)
+  {
+    samples=sequence+pixel*PixelStride;
+    kernel=Centered(SDbins[pixel],image[pixel]);
+  }
+
+  float operator()(unsigned int j) const
+  {
+    return kernel[*Sample(j)];
+  }
+};
+
+struct RGBKernel : PixelKernel
+{
+  const float *kernel1;
+  const float *kernel2;
+  const float *kernel3;
+
+  void SetPixel(unsigned int pixel)
+  {
+    unsigned int i=pixel*3;
+
+    // used extimated kernel width to access the right kernel
+    samples=sequence+pixel*PixelStride;
+    kernel1=Centered(SDbins[i],image[i]);
+    kernel2=Centered(SDbins[i+1],image[i+1]);
+    kernel3=Centered(SDbins[i+2],image[i+2]);
+  }
+
+  float operator()(unsigned int j) const
+  {
+    const unsigned char *sample=Sample(j);
+    return kernel1[sample[0]]*kernel2[sample[1]]*kernel3[sample[2]];
+  }
+};
+
+// Samples out of the brightness range of the pixel do not contribute.
+struct ColorRatiosSubsetKernel : PixelKernel
+{
+  const int *x1;
+  const int *x2;
+  int brightness;
+  const float *kernel2;
+  const float *kernel3;
+
+  void SetPixel(unsigned int pixel)
+  {
+    unsigned int i=pixel*3;
+
+    samples=sequence+pixel*PixelStride;
+    brightness=image[i];
+    kernel2=Centered(SDbins[i+1],image[i+1]);
+    kernel3=Centered(SDbins[i+2],image[i+2]);
+  }
+
+  float operator()(unsigned int j) const
+  {
+    const unsigned char *sample=Sample(j);
+
+    if (x1[sample[0]] < brightness && brightness < x2[sample[0]])
+      return kernel2[sample[1]]*kernel3[sample[2]];
+
+    return 0;
+  }
+};
+
+// The bandwidth of the brightness kernel depends on the brightness.
+struct ColorRatiosKernel : PixelKernel
+{
+  const int *gbase;
+  const float *kernel1;
+  const float *kernel2;
+  const float *kernel3;
+
+  void SetPixel(unsigned int pixel)
+  {
+    unsigned int i=pixel*3;
+
+    samples=sequence+pixel*PixelStride;
+    kernel1=Centered(0,image[i]);
+    kernel2=Centered(SDbins[i+1],image[i+1]);
+    kernel3=Centered(SDbins[i+2],image[i+2]);
+  }
+
+  float operator()(unsigned int j) const
+  {
+    const unsigned char *sample=Sample(j);
+    return kernel1[gbase[sample[0]]+sample[0]]*kernel2[sample[1]]*kernel3[sample[2]];
+  }
+};
+
+template <class Kernel>
+static inline float KernelOrZero(const Kernel& kernel,
+                                 unsigned int j,
+                                 unsigned int SampleSize)
+{
+  return (j<SampleSize) ? kernel(j) : 0;
+}
+
+/*
+ * Sums the kernels of the samples of a pixel until the sum reaches th, and
+ * sets j to the number of samples summed. Most of the background pixels
+ * reach th with their first sample, which is thus evaluated alone. Then the
+ * samples are evaluated by blocks of NPBG_BLOCK, summed in as many lanes,
+ * and the early exit is checked once per block. In exact arithmetic, this
+ * gives the same mask as checking after each sample: in both cases, p=sum/j
+ * is at least Threshold once th is reached, and is the mean of all the
+ * kernels otherwise. As the lanes change the order of the additions, the
+ * masks can however differ for the pixels whose p is within rounding
+ * distance of Threshold.
+ */
+template <class Kernel>
+static inline float SumKernelsScalar(const Kernel& kernel,
+                                     unsigned int SampleSize,
+                                     double th,
+                                     unsigned int& j)
+{
+  float sum=kernel(0);
+  j=1;
+
+  float acc[NPBG_BLOCK]={sum,0,0,0};
+
+  while (j<SampleSize && sum < th)
+  {
+    for (unsigned int l=0;l<NPBG_BLOCK;l++)
+      acc[l]+=KernelOrZero(kernel,j+l,SampleSize);
+    j+=NPBG_BLOCK;
+
+    sum=(acc[0]+acc[2])+(acc[1]+acc[3]);
+  }
+
+  j=(j<SampleSize) ? j : SampleSize;
+  return sum;
+}
+
+#ifdef NPBG_SSE2
+// Same as SumKernelsScalar, with the lanes in an SSE2 register.
+template <class Kernel>
+static inline float SumKernelsSSE2(const Kernel& kernel,
+                                   unsigned int SampleSize,
+                                   double th,
+                                   unsigned int& j)
+{
+  float sum=kernel(0);
+  j=1;
+
+  __m128 acc=_mm_set_ss(sum);
+  __m128 half;
+
+  while (j<SampleSize && sum < th)
+  {
+    acc=_mm_add_ps(acc,_mm_set_ps(KernelOrZero(kernel,j+3,SampleSize),
+                                  KernelOrZero(kernel,j+2,SampleSize),
+                                  KernelOrZero(kernel,j+1,SampleSize),
+                                  kernel(j)));
+    j+=NPBG_BLOCK;
+
+    half=_mm_add_ps(acc,_mm_movehl_ps(acc,acc));
+    sum=_mm_cvtss_f32(_mm_add_ss(half,_mm_shuffle_ps(half,half,1)));
+  }
+
+  j=(j<SampleSize) ? j : SampleSize;
+  return sum;
+}
+#endif
+
+template <class Kernel>
+static inline float SumKernels(const Kernel& kernel,
+                               unsigned int SampleSize,
+                               double th,
+                               unsigned int& j)
+{
+#ifdef NPBG_SSE2
+  return SumKernelsSSE2(kernel,SampleSize,th,j);
+#else
+  return SumKernelsScalar(kernel,SampleSize,th,j);
+#endif
+}
+
+// Computes the probabilities of the pixels [first, end), with a copy of the
+// kernel so that distinct bands can run concurrently.
+template <class Kernel>
+static void SumKernelsRange(Kernel kernel,
+                            unsigned int first,
+                            unsigned int end,
+                            unsigned int SampleSize,
+                            double th,
+                            double * Pimage)
+{
+  unsigned int j;
+  float sum;
+
+  for (unsigned int pixel=first;pixel<end;pixel++)
+  {
+    kernel.SetPixel(pixel);
+    sum=SumKernels(kernel,SampleSize,th,j);
+
+    Pimage[pixel]=sum/j;
+  }
+}
+
 void NPBGSubtractor::NPBGSubtraction_Subset_Kernel(
   unsigned char * image,
   unsigned char * FGImage,
   unsigned char * FilteredFGImage)
 {
-  unsigned int i,j;
-  unsigned char *pSequence 	=BGModel->Sequence;
-
   unsigned int SampleSize			= BGModel->SampleSize;
 
-  double *kerneltable	= KernelTable->kerneltable;
-  int KernelHalfWidth		= KernelTable->tablehalfwidth;
-  double *KernelSum			= KernelTable->kernelsums;
   double KernelMaxSigma = KernelTable->maxsegma;
   double KernelMinSigma = KernelTable->minsegma;
   int KernelBins				= KernelTable->segmabins;
-  unsigned char * SDbins= BGModel->SDbinsImage;
-
-  unsigned char * SaturationImage=FilteredFGImage;
-
-  // default sigmas .. to be removed.
-  double sigma1;
-  double sigma2;
-  double sigma3;
 
-  sigma1=2.25;
-  sigma2=2.25;
-  sigma3=2.25;
+  unsigned int kerneltablewidth=2*KernelTable->tablehalfwidth+1;
 
-  double p;
   double th;
 
   double alpha;
@@ -913,47 +1167,34 @@ void NPBGSubtractor::NPBGSubtraction_Subset_Kernel(
   //Threshold=1;
   th = Threshold * SampleSize;
 
-  double sum=0,kernel1,kernel2,kernel3;
-  int k,g;
+  int g;
 
+  PixelKernel pixelkernel;
+  pixelkernel.sequence=BGModel->Sequence;
+  pixelkernel.SampleStride=BGModel->SampleStride;
+  pixelkernel.PixelStride=BGModel->PixelStride;
+  pixelkernel.image=image;
+  pixelkernel.SDbins=BGModel->SDbinsImage;
+  pixelkernel.kerneltable=KernelTable->kerneltable;
+  pixelkernel.kerneltablewidth=kerneltablewidth;
+  pixelkernel.KernelHalfWidth=KernelTable->tablehalfwidth;
 
   if (color_channels==1) 
   {
     // gray scale
 
-    int kernelbase;
-    
-    for (i=0;i<rows*cols;i++)
-    {
-      kernelbase=SDbins[i]*(2*KernelHalfWidth+1);
-      sum=0;
-      j=0;
+    GrayKernel kernel;
+    static_cast<PixelKernel&>(kernel)=pixelkernel;
 
-      while (j<SampleSize && sum < th)
-      {
-        g=pSequence[j*imagesize+i];
-        k= g-  image[i] +KernelHalfWidth;
-        sum+=kerneltable[kernelbase+k];
-        j++;
-      }
-
-      p=sum/j;
-      Pimage1[i]=p;
-    }
+    ForEachBand([&](unsigned int first, unsigned int end)
+    {
+      SumKernelsRange(kernel,first,end,SampleSize,th,Pimage1);
+    });
   }
   else if (UseColorRatiosFlag && SubsetFlag)
   {
     // color ratios
 
-    unsigned int ig;
-    int base;
-
-    int kernelbase1;
-    int kernelbase2;
-    int kernelbase3;
-
-    unsigned int kerneltablewidth=2*KernelHalfWidth+1;
-
     double beta=3.0;    // minimum bound on the range.
     double betau=100.0;
 
@@ -963,75 +1204,43 @@ void NPBGSubtractor::NPBGSubtraction_Subset_Kernel(
 
     double brightness_lowerbound = 1-alpha;
     double brightness_upperbound = 1+alpha;
-    int x1,x2;
-    unsigned int SubsampleCount;
-
-    for (i=0,ig=0;i<imagesize;i+=3,ig++)
-    {
-      kernelbase1=SDbins[i]*kerneltablewidth;
-      kernelbase2=SDbins[i+1]*kerneltablewidth;
-      kernelbase3=SDbins[i+2]*kerneltablewidth;
 
-      sum=0;
-      j=0;
-      SubsampleCount=0;
+    // brightness range of each sample value, computed once for all the pixels
+    int x1[256],x2[256];
 
-      while (j<SampleSize && sum < th)
+    for (g=0;g<256;g++)
+    {
+      if (g < beta_over_alpha)
       {
-        base=j*imagesize+i;
-        g=pSequence[base];
-        
-        if (g < beta_over_alpha)
-        {
-          x1=(int) (g-beta);
-          x2=(int) (g+beta);
-        }
-        else if (g > betau_over_alpha)
-        {
-          x1=(int) (g-betau);
-          x2=(int) (g+betau);
-        }
-        else
-        {
-          x1=(int) (g*brightness_lowerbound+0.5);
-          x2=(int) (g*brightness_upperbound+0.5);
-        }
-
-        if(x1<image[i] && image[i] <x2)
-        {
-          g=pSequence[base+1];
-          k= (g-  image[i+1]) +KernelHalfWidth;
-          kernel2=kerneltable[kernelbase2+k];
-
-          g=pSequence[base+2];
-          k= (g-  image[i+2]) +KernelHalfWidth;
-          kernel3=kerneltable[kernelbase3+k];
-
-          sum+=kernel2*kernel3;
-
-          SubsampleCount++;
-        }
-        j++;
+        x1[g]=(int) (g-beta);
+        x2[g]=(int) (g+beta);
+      }
+      else if (g > betau_over_alpha)
+      {
+        x1[g]=(int) (g-betau);
+        x2[g]=(int) (g+betau);
       }
+      else
+      {
+        x1[g]=(int) (g*brightness_lowerbound+0.5);
+        x2[g]=(int) (g*brightness_upperbound+0.5);
+      }
+    }
 
-      p=sum / j;
-      Pimage1[ig]=p;
-    }	
+    ColorRatiosSubsetKernel kernel;
+    static_cast<PixelKernel&>(kernel)=pixelkernel;
+    kernel.x1=x1;
+    kernel.x2=x2;
+
+    ForEachBand([&](unsigned int first, unsigned int end)
+    {
+      SumKernelsRange(kernel,first,end,SampleSize,th,Pimage1);
+    });
   }
   else if (UseColorRatiosFlag && ! SubsetFlag)
   {
     // color ratios
 
-    unsigned int ig;
-    int base;
-    int bin;
-
-    int kernelbase1;
-    int kernelbase2;
-    int kernelbase3;
-
-    unsigned int kerneltablewidth=2*KernelHalfWidth+1;
-
     int gmin,gmax;
     double gfactor;
 
@@ -1040,92 +1249,37 @@ void NPBGSubtractor::NPBGSubtraction_Subset_Kernel(
 
     gfactor = (KernelMaxSigma-KernelMinSigma) / (double) (gmax - gmin);
 
-    for (i=0,ig=0;i<imagesize;i+=3,ig++)
-    {
-
-      bin=(int) floor(((alpha*16-KernelMinSigma)*KernelBins)/(KernelMaxSigma-KernelMinSigma));
+    // kernel bin of each brightness value, computed once for all the pixels
+    int gbase[256];
 
-      kernelbase1=bin*kerneltablewidth;
-      kernelbase2=SDbins[i+1]*kerneltablewidth;
-      kernelbase3=SDbins[i+2]*kerneltablewidth;
-
-      sum=0;
-      j=0;
-
-      while (j<SampleSize && sum < th)
-      {
-        base=j*imagesize+i;
-        g=pSequence[base];
-
-        if (g < gmin )
-          bin=0;
-        else if (g > gmax)
-          bin = KernelBins -1 ;
-        else
-          bin= (int) ((g-gmin) * gfactor + 0.5);
-        
-        kernelbase1=bin*kerneltablewidth;
-
-        k= (g-  image[i]) +KernelHalfWidth;
-        kernel1=kerneltable[kernelbase1+k];
-
-        g=pSequence[base+1];
-        k= (g-  image[i+1]) +KernelHalfWidth;
-        kernel2=kerneltable[kernelbase2+k];
-
-        g=pSequence[base+2];
-        k= (g-  image[i+2]) +KernelHalfWidth;
-        kernel3=kerneltable[kernelbase3+k];
+    for (g=0;g<256;g++)
+    {
+      if (g < gmin )
+        gbase[g]=0;
+      else if (g > gmax)
+        gbase[g]=(KernelBins -1)*kerneltablewidth;
+      else
+        gbase[g]=((int) ((g-gmin) * gfactor + 0.5))*kerneltablewidth;
+    }
 
-        sum+=kernel1*kernel2*kernel3;
-        j++;
-      }
+    ColorRatiosKernel kernel;
+    static_cast<PixelKernel&>(kernel)=pixelkernel;
+    kernel.gbase=gbase;
 
-      p=sum / j;
-      Pimage1[ig]=p;
-    }
+    ForEachBand([&](unsigned int first, unsigned int end)
+    {
+      SumKernelsRange(kernel,first,end,SampleSize,th,Pimage1);
+    });
   }
   else // RGB color
   {
-    unsigned int ig;
-    int base;
-
-    int kernelbase1;
-    int kernelbase2;
-    int kernelbase3;
-    unsigned int kerneltablewidth=2*KernelHalfWidth+1;
+    RGBKernel kernel;
+    static_cast<PixelKernel&>(kernel)=pixelkernel;
 
-    for (i=0,ig=0;i<imagesize;i+=3,ig++)
+    ForEachBand([&](unsigned int first, unsigned int end)
     {
-      // used extimated kernel width to access the right kernel
-      kernelbase1=SDbins[i]*kerneltablewidth;
-      kernelbase2=SDbins[i+1]*kerneltablewidth;
-      kernelbase3=SDbins[i+2]*kerneltablewidth;
-
-      sum=0;
-      j=0;
-      while (j<SampleSize && sum < th)
-      {
-        base=j*imagesize+i;
-        g=pSequence[base];
-        k= (g-  image[i]) +KernelHalfWidth;
-        kernel1=kerneltable[kernelbase1+k];
-
-        g=pSequence[base+1];
-        k= (g-  image[i+1]) +KernelHalfWidth;
-        kernel2=kerneltable[kernelbase2+k];
-
-        g=pSequence[base+2];
-        k= (g-  image[i+2]) +KernelHalfWidth;
-        kernel3=kerneltable[kernelbase3+k];
-
-        sum+=kernel1*kernel2*kernel3;
-        j++;
-      }
-      
-      p=sum/j;
-      Pimage1[ig]=p;
-    }
+      SumKernelsRange(kernel,first,end,SampleSize,th,Pimage1);
+    });
   }
 
   DisplayPropabilityImageWithThresholding(Pimage1,FGImage,Threshold,rows,cols);
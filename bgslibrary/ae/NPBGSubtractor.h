@@ -59,6 +59,7 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "NPBGmodel.h"
 #include "KernelTable.h"
+#include "../WorkerPool.h"
 
 #define FALSE 0
 #define TRUE 1
@@ -89,6 +90,10 @@ typedef struct
 
 class NPBGSubtractor  
 {
+public:
+  // runs on the pixels [first, end) of a band of rows
+  typedef std::function<void(unsigned int, unsigned int)> BandTask;
+
 private:
   unsigned int rows;
   unsigned int cols;
@@ -105,6 +110,9 @@ private:
   double Threshold;
   double AlphaValue;
   unsigned int TimeIndex;
+  // frames put in the temporal buffer, counted per subtractor so that a new
+  // one does not update from slots it has not filled yet
+  int TBCount;
   ImageIndex  *imageindex;
   unsigned char *tempFrame;
   KernelLUTable *KernelTable;
@@ -112,12 +120,15 @@ private:
   DynamicMedianHistogram AbsDiffHist;
   double *Pimage1;
   double *Pimage2;
+  // the bands of rows are processed concurrently, reading the kernel table
+  WorkerPool workers;
   //
+  void ForEachBand(const BandTask& task);
   void NPBGSubtraction_Subset_Kernel(unsigned char * image, unsigned char * FGImage, unsigned char * FilteredFGImage);
   void SequenceBGUpdate_Pairs(unsigned char * image, unsigned char * Mask);
 
 public:
-  NPBGSubtractor();
+  NPBGSubtractor(unsigned int threads = 1);
   virtual ~NPBGSubtractor();
   //~NPBGSubtractor();
 
@@ -127,7 +138,8 @@ public:
     unsigned int SequenceLength,
     unsigned int TimeWindowSize,
     unsigned char SDEstimationFlag,
-    unsigned char UseColorRatiosFlag);
+    unsigned char UseColorRatiosFlag,
+    unsigned char PixelMajorFlag = FALSE);
 
   void AddFrame(unsigned char * ImageBuffer);
 
@@ -65,7 +65,9 @@ static char THIS_FILE[]=__FILE__;
 
 NPBGmodel::NPBGmodel()
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "NPBGmodel()" << std::endl;
+#endif
 }
 
 NPBGmodel::~NPBGmodel()
@@ -76,7 +78,9 @@ NPBGmodel::~NPBGmodel()
   delete TemporalMask;
   delete AccMask;
   //delete SDbinsImage;
+#ifndef LABGEN_HEADLESS
   std::cout << "~NPBGmodel()" << std::endl;
+#endif
 }
 
 NPBGmodel::NPBGmodel(unsigned int Rows,
@@ -84,9 +88,12 @@ NPBGmodel::NPBGmodel(unsigned int Rows,
                      unsigned int ColorChannels,
                      unsigned int Length,
                      unsigned int pTimeWindowSize,
-                     unsigned int bg_suppression_time)
+                     unsigned int bg_suppression_time,
+                     bool PixelMajor)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "NPBGmodel()" << std::endl;
+#endif
 
   imagesize = Rows*Cols*ColorChannels;
 
@@ -96,6 +103,17 @@ NPBGmodel::NPBGmodel(unsigned int Rows,
 
   SampleSize = Length;
 
+  if (PixelMajor)
+  {
+    SampleStride = ColorChannels;
+    PixelStride = Length*ColorChannels;
+  }
+  else
+  {
+    SampleStride = imagesize;
+    PixelStride = ColorChannels;
+  }
+
   TimeWindowSize = pTimeWindowSize;
 
   Sequence	= new unsigned char[imagesize*Length];
@@ -118,7 +136,19 @@ NPBGmodel::NPBGmodel(unsigned int Rows,
 
 void NPBGmodel::AddFrame(unsigned char *ImageBuffer)		
 {
-  memcpy(Sequence+Top*imagesize,ImageBuffer,imagesize);
+  if (PixelStride == color_channels)
+    memcpy(Sequence+Top*SampleStride,ImageBuffer,imagesize);
+  else
+  {
+    unsigned char *pSample = Sequence+Top*SampleStride;
+
+    for (unsigned int i = 0; i < imagesize; i += color_channels)
+    {
+      memcpy(pSample,ImageBuffer+i,color_channels);
+      pSample += PixelStride;
+    }
+  }
+
   Top = (Top + 1) % SampleSize;		
 
   memset(PixelQTop, (unsigned char) Top, rows*cols);
@@ -59,11 +59,19 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 
+/*
+ * The samples are stored either frame by frame (the i-th sample of every
+ * pixel forms an image), or pixel by pixel (the samples of a pixel are
+ * contiguous). The channel ch of the j-th sample of the pixel p lies at
+ * Sequence[p*PixelStride+j*SampleStride+ch] in both layouts.
+ */
 class NPBGmodel  
 {
 private:
   unsigned char *Sequence;
   unsigned int SampleSize;
+  unsigned int SampleStride;
+  unsigned int PixelStride;
   unsigned int TimeWindowSize;
 
   unsigned int rows,cols,color_channels;
@@ -101,7 +109,8 @@ public:
     unsigned int ColorChannels,
     unsigned int Length,
     unsigned int pTimeWindowSize,
-    unsigned int bg_suppression_time);
+    unsigned int bg_suppression_time,
+    bool PixelMajor = false);
 
   void AddFrame(unsigned char *ImageBuffer);
 
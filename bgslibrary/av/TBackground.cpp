@@ -26,13 +26,17 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 TBackground::TBackground(void)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "TBackground()" << std::endl;
+#endif
 }
 
 TBackground::~TBackground(void)
 {
   Clear();
+#ifndef LABGEN_HEADLESS
   std::cout << "~TBackground()" << std::endl;
+#endif
 }
 
 void TBackground::Clear(void)
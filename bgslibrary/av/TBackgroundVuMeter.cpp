@@ -33,13 +33,17 @@ TBackgroundVuMeter::TBackgroundVuMeter(void)
   , m_fAlpha(0.995)
   , m_fThreshold(0.03)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "TBackgroundVuMeter()" << std::endl;
+#endif
 }
 
 TBackgroundVuMeter::~TBackgroundVuMeter(void)
 {
   Clear();
+#ifndef LABGEN_HEADLESS
   std::cout << "~TBackgroundVuMeter()" << std::endl;
+#endif
 }
 
 void TBackgroundVuMeter::Clear(void)
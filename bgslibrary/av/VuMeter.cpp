@@ -16,9 +16,12 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "VuMeter.h"
 
-VuMeter::VuMeter() : firstTime(true), showOutput(true), enableFilter(true), binSize(8), alpha(0.995), threshold(0.03)
+VuMeter::VuMeter(const VuMeterParams& parameters) : firstTime(true), showOutput(parameters.showOutput), enableFilter(parameters.enableFilter),
+  binSize(parameters.binSize), alpha(parameters.alpha), threshold(parameters.threshold)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "VuMeter()" << std::endl;
+#endif
 }
 
 VuMeter::~VuMeter()
@@ -27,17 +30,39 @@ VuMeter::~VuMeter()
   cvReleaseImage(&background);
   cvReleaseImage(&gray);
 
+#ifndef LABGEN_HEADLESS
   std::cout << "~VuMeter()" << std::endl;
+#endif
 }
 
 void VuMeter::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
 {
   if(img_input.empty())
     return;
-  else
-    frame = new IplImage(img_input);
 
-  loadConfig();
+  img_foreground.create(img_input.size(), CV_8UC1);
+  processMask(img_input, img_foreground);
+
+  cv::Mat img_bkg = cv::cvarrToMat(background);
+
+#ifndef LABGEN_HEADLESS
+  if(showOutput)
+  {
+    if(!img_foreground.empty())
+      cv::imshow("VuMeter", img_foreground);
+    
+    if(!img_bkg.empty())
+      cv::imshow("VuMeter Bkg Model", img_bkg);
+  }
+#endif
+
+  img_foreground.copyTo(img_output);
+  img_bkg.copyTo(img_bgmodel);
+}
+
+bool VuMeter::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
+{
+  frame = IplImage(img_input);
 
   if(firstTime)
   {
@@ -45,72 +70,30 @@ void VuMeter::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &im
     bgs.SetBinSize(binSize);
     bgs.SetThreshold(threshold);
 
-    gray = cvCreateImage(cvGetSize(frame),IPL_DEPTH_8U,1);
-    cvCvtColor(frame,gray,CV_RGB2GRAY);
+    gray = cvCreateImage(cvGetSize(&frame),IPL_DEPTH_8U,1);
+    cvCvtColor(&frame,gray,CV_RGB2GRAY);
 
     background = cvCreateImage(cvGetSize(gray),IPL_DEPTH_8U,1);
     cvCopy(gray, background);
 
     mask = cvCreateImage(cvGetSize(gray),IPL_DEPTH_8U,1);
     cvZero(mask);
-
-    saveConfig();
   }
   else
-    cvCvtColor(frame,gray,CV_RGB2GRAY);
+    cvCvtColor(&frame,gray,CV_RGB2GRAY);
   
   bgs.UpdateBackground(gray,background,mask);
-  cv::Mat img_foreground = cv::cvarrToMat(mask);
-  cv::Mat img_bkg = cv::cvarrToMat(background);
+  cv::Mat foreground = cv::cvarrToMat(mask);
 
+  // the mask of the model is left as is, the filtered one goes to the caller
   if(enableFilter)
   {
-    cv::erode(img_foreground,img_foreground,cv::Mat());
-    cv::medianBlur(img_foreground, img_foreground, 5);
-  }
-
-  if(showOutput)
-  {
-    if(!img_foreground.empty())
-      cv::imshow("VuMeter", img_foreground);
-    
-    if(!img_bkg.empty())
-      cv::imshow("VuMeter Bkg Model", img_bkg);
+    cv::erode(foreground,img_eroded,cv::Mat());
+    cv::medianBlur(img_eroded, img_mask, 5);
   }
+  else
+    foreground.copyTo(img_mask);
 
-  img_foreground.copyTo(img_output);
-  img_bkg.copyTo(img_bgmodel);
-  
-  delete frame;
   firstTime = false;
-}
-
-void VuMeter::saveConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/VuMeter.xml", 0, CV_STORAGE_WRITE);
-
-  cvWriteInt(fs, "enableFilter", enableFilter);
-  
-  cvWriteInt(fs, "binSize", binSize);
-  cvWriteReal(fs, "alpha", alpha);
-  cvWriteReal(fs, "threshold", threshold);
-  
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
-}
-
-void VuMeter::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/VuMeter.xml", 0, CV_STORAGE_READ);
-  
-  enableFilter = cvReadIntByName(fs, 0, "enableFilter", true);
-  
-  binSize = cvReadIntByName(fs, 0, "binSize", 8);
-  alpha = cvReadRealByName(fs, 0, "alpha", 0.995);
-  threshold = cvReadRealByName(fs, 0, "threshold", 0.03);
-  
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
-
-  cvReleaseFileStorage(&fs);
+  return true;
 }
@@ -22,16 +22,19 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "TBackgroundVuMeter.h"
 #include "../IBGS.h"
+#include "../BGSParams.h"
 
 class VuMeter : public IBGS
 {
 private:
   TBackgroundVuMeter bgs;
 
-  IplImage *frame;
+  IplImage frame;
   IplImage *gray;
   IplImage *background;
   IplImage *mask;
+  cv::Mat img_eroded;
+  cv::Mat img_foreground;
   
   bool firstTime;
   bool showOutput;
@@ -42,12 +45,9 @@ private:
   double threshold;
   
 public:
-  VuMeter();
+  VuMeter(const VuMeterParams& parameters = VuMeterParams());
   ~VuMeter();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
-
-private:
-  void saveConfig();
-  void loadConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
@@ -1,20 +1,24 @@
 #include "SigmaDeltaBGS.h"
 
-SigmaDeltaBGS::SigmaDeltaBGS() :
+SigmaDeltaBGS::SigmaDeltaBGS(const SigmaDeltaParams& parameters) :
 firstTime(true),
-ampFactor(1),
-minVar(15),
-maxVar(255),
+ampFactor(parameters.ampFactor),
+minVar(parameters.minVar),
+maxVar(parameters.maxVar),
 algorithm(sdLaMa091New()),
-showOutput(true) {
+showOutput(parameters.showOutput) {
 
   applyParams();
+#ifndef LABGEN_HEADLESS
   std::cout << "SigmaDeltaBGS()" << std::endl;
+#endif
 }
 
 SigmaDeltaBGS::~SigmaDeltaBGS() {
   sdLaMa091Free(algorithm);
+#ifndef LABGEN_HEADLESS
   std::cout << "~SigmaDeltaBGS()" << std::endl;
+#endif
 }
 
 void SigmaDeltaBGS::process(
@@ -25,57 +29,30 @@ void SigmaDeltaBGS::process(
   if (img_input.empty())
     return;
 
-  loadConfig();
+  img_foreground.create(img_input.rows, img_input.cols, CV_8UC1);
 
-  if (firstTime) {
-    saveConfig();
-    sdLaMa091AllocInit_8u_C3R(algorithm, img_input.data, img_input.cols, img_input.rows, img_input.step);
-
-    firstTime = false;
+  if (!processMask(img_input, img_foreground))
     return;
-  }
-
-  img_output = cv::Mat(img_input.rows, img_input.cols, CV_8UC1);
-  cv::Mat img_output_tmp(img_input.rows, img_input.cols, CV_8UC3);
-
-  sdLaMa091Update_8u_C3R(algorithm, img_input.data, img_output_tmp.data);
-
-  unsigned char* tmpBuffer = (unsigned char*)img_output_tmp.data;
-  unsigned char* outBuffer = (unsigned char*)img_output.data;
-
-  for (size_t i = 0; i < img_output.total(); ++i) {
-    *outBuffer = *tmpBuffer;
-
-    ++outBuffer;
-    tmpBuffer += img_output_tmp.channels();
-  }
 
+#ifndef LABGEN_HEADLESS
   if (showOutput)
-    cv::imshow("Sigma-Delta", img_output);
-}
-
-void SigmaDeltaBGS::saveConfig() {
-  CvFileStorage* fs = cvOpenFileStorage("./config/SigmaDeltaBGS.xml", 0, CV_STORAGE_WRITE);
+    cv::imshow("Sigma-Delta", img_foreground);
+#endif
 
-  cvWriteInt(fs, "ampFactor", ampFactor);
-  cvWriteInt(fs, "minVar", minVar);
-  cvWriteInt(fs, "maxVar", maxVar);
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
+  img_foreground.copyTo(img_output);
 }
 
-void SigmaDeltaBGS::loadConfig() {
-  CvFileStorage* fs = cvOpenFileStorage("./config/SigmaDeltaBGS.xml", 0, CV_STORAGE_READ);
+bool SigmaDeltaBGS::processMask(const cv::Mat &img_input, cv::Mat &img_mask) {
+  if (firstTime) {
+    sdLaMa091AllocInit_8u_C3R(algorithm, img_input.data, img_input.cols, img_input.rows, img_input.step);
 
-  ampFactor = cvReadIntByName(fs, 0, "ampFactor", 1);
-  minVar = cvReadIntByName(fs, 0, "minVar", 15);
-  maxVar = cvReadIntByName(fs, 0, "maxVar", 255);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
+    firstTime = false;
+    return false;
+  }
 
-  applyParams();
+  sdLaMa091Update_8u_C3C1R(algorithm, img_input.data, img_mask.data, img_mask.step);
 
-  cvReleaseFileStorage(&fs);
+  return true;
 }
 
 void SigmaDeltaBGS::applyParams() {
@@ -5,6 +5,7 @@
 
 
 #include "../IBGS.h"
+#include "../BGSParams.h"
 
 //extern "C" {
 #include "sdLaMa091.h"
@@ -19,10 +20,11 @@ private:
   unsigned int maxVar;
   sdLaMa091_t* algorithm;
   bool showOutput;
+  cv::Mat img_foreground;
 
 public:
 
-  SigmaDeltaBGS();
+  SigmaDeltaBGS(const SigmaDeltaParams& parameters = SigmaDeltaParams());
 
   ~SigmaDeltaBGS();
 
@@ -32,11 +34,9 @@ public:
     cv::Mat &img_bgmodel
     );
 
-private:
-
-  void saveConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 
-  void loadConfig();
+private:
 
   void applyParams();
 };
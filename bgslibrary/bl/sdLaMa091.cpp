@@ -17,6 +17,21 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "sdLaMa091.h"
 
+/*
+ * The updates are computed by a fused kernel processing a row in a single
+ * pass. Unless SDLAMA091_NO_SIMD is defined, the kernel uses SSE2, or AVX2
+ * when the CPU supports it (detected at runtime with GCC and Clang).
+ */
+#if !defined(SDLAMA091_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SDLAMA091_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDLAMA091_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
 #define DEFAULT_N 1
 #define DEFAULT_VMIN 2
 #define DEFAULT_VMAX 255
@@ -51,6 +66,7 @@ struct sdLaMa091 {
   uint8_t* Mt;
   uint8_t* Ot;
   uint8_t* Vt;
+  uint8_t* Lt;
 };
 
 #if defined(DEFENSIVE_ALLOC) || defined(DEFENSIVE_POINTER) || \
@@ -62,6 +78,41 @@ static inline uint8_t absVal(int8_t num);
 static inline uint8_t min(uint8_t a, uint8_t b);
 static inline uint8_t max(uint8_t a, uint8_t b);
 
+typedef void (*updateRow_t)(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count);
+
+static void updateRowScalar(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count);
+#ifdef SDLAMA091_SSE2
+static void updateRowSSE2(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count);
+#endif
+#ifdef SDLAMA091_AVX2
+static void updateRowAVX2(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count);
+#endif
+static updateRow_t selectUpdateRow(void);
+
 #if defined(DEFENSIVE_ALLOC) || defined(DEFENSIVE_POINTER) || \
   defined(DEFENSIVE_PARAM)
 
@@ -83,6 +134,190 @@ static inline uint8_t max(uint8_t a, uint8_t b) {
   return (a > b) ? a : b;
 }
 
+/*
+ * Updates Mt, Ot and Vt for count consecutive bytes and writes the label of
+ * each byte, exactly as the separated passes of the original algorithm did.
+ * Note that Ot is the absolute value of the 8-bit wrapped difference, that
+ * Vt wraps to 0 when it is 255 and N * Ot is larger, and that Vmin and Vmax
+ * are truncated to 8 bits: the vectorized kernels reproduce these behaviors.
+ */
+static void updateRowScalar(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count) {
+  for (uint32_t j = 0; j < count; ++j) {
+    if (workMt[j] < workImage[j])
+      ++workMt[j];
+    else if (workMt[j] > workImage[j])
+      --workMt[j];
+
+    workOt[j] = absVal(workMt[j] - workImage[j]);
+
+    uint32_t ampOt = sdLaMa091->N * workOt[j];
+
+    if (workVt[j] < ampOt)
+      ++workVt[j];
+    else if (workVt[j] > ampOt)
+      --workVt[j];
+
+    workVt[j] = max(min(workVt[j], sdLaMa091->Vmax), sdLaMa091->Vmin);
+
+    if (workOt[j] < workVt[j])
+      labels[j] = BACKGROUND;
+    else
+      labels[j] = FOREGROUND;
+  }
+}
+
+/*
+ * N * Ot is computed on 16 bits and saturated to 255. The lanes for which it
+ * exceeds 255 are the ones where Ot > 255 / N, and the low byte of the
+ * product is exact for the other ones, even with N clamped to 255.
+ */
+static inline uint8_t ampThreshold(const uint32_t N) {
+  return (N == 0) ? 255 : (uint8_t)(255 / N);
+}
+
+static inline uint16_t ampFactor(const uint32_t N) {
+  return (uint16_t)(N < 255 ? N : 255);
+}
+
+#ifdef SDLAMA091_SSE2
+static void updateRowSSE2(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi8(1);
+  const __m128i ones = _mm_set1_epi8((char)0xFF);
+  const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+  const __m128i threshold = _mm_set1_epi8((char)ampThreshold(sdLaMa091->N));
+  const __m128i factor = _mm_set1_epi16((short)ampFactor(sdLaMa091->N));
+  const __m128i vmin = _mm_set1_epi8((char)(uint8_t)sdLaMa091->Vmin);
+  const __m128i vmax = _mm_set1_epi8((char)(uint8_t)sdLaMa091->Vmax);
+
+  uint32_t j = 0;
+
+  for (; j + 16 <= count; j += 16) {
+    __m128i I = _mm_loadu_si128((const __m128i*)(workImage + j));
+    __m128i M = _mm_loadu_si128((const __m128i*)(workMt + j));
+    __m128i V = _mm_loadu_si128((const __m128i*)(workVt + j));
+
+    /* Moves Mt one step toward I. */
+    M = _mm_max_epu8(_mm_min_epu8(_mm_adds_epu8(M, one), I),
+      _mm_subs_epu8(M, one));
+
+    __m128i D = _mm_sub_epi8(M, I);
+    __m128i O = _mm_min_epu8(D, _mm_sub_epi8(zero, D));
+
+    /* Saturated N * Ot. */
+    __m128i big = _mm_andnot_si128(
+      _mm_cmpeq_epi8(_mm_subs_epu8(O, threshold), zero), ones);
+    __m128i ampLo = _mm_and_si128(
+      _mm_mullo_epi16(_mm_unpacklo_epi8(O, zero), factor), lowBytes);
+    __m128i ampHi = _mm_and_si128(
+      _mm_mullo_epi16(_mm_unpackhi_epi8(O, zero), factor), lowBytes);
+    __m128i amp = _mm_or_si128(_mm_packus_epi16(ampLo, ampHi), big);
+
+    /* Moves Vt one step toward N * Ot, wraps, then clamps. */
+    __m128i wrap = _mm_and_si128(big, _mm_cmpeq_epi8(V, ones));
+    V = _mm_max_epu8(_mm_min_epu8(_mm_adds_epu8(V, one), amp),
+      _mm_subs_epu8(V, one));
+    V = _mm_andnot_si128(wrap, V);
+    V = _mm_max_epu8(_mm_min_epu8(V, vmax), vmin);
+
+    /* Ot >= Vt is the foreground. */
+    __m128i L = _mm_cmpeq_epi8(_mm_max_epu8(O, V), O);
+
+    _mm_storeu_si128((__m128i*)(workMt + j), M);
+    _mm_storeu_si128((__m128i*)(workOt + j), O);
+    _mm_storeu_si128((__m128i*)(workVt + j), V);
+    _mm_storeu_si128((__m128i*)(labels + j), L);
+  }
+
+  updateRowScalar(sdLaMa091, workImage + j, workMt + j, workOt + j,
+    workVt + j, labels + j, count - j);
+}
+#endif
+
+#ifdef SDLAMA091_AVX2
+__attribute__((target("avx2")))
+static void updateRowAVX2(const sdLaMa091_t* sdLaMa091,
+  const uint8_t* workImage,
+  uint8_t* workMt,
+  uint8_t* workOt,
+  uint8_t* workVt,
+  uint8_t* labels,
+  const uint32_t count) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi8(1);
+  const __m256i ones = _mm256_set1_epi8((char)0xFF);
+  const __m256i lowBytes = _mm256_set1_epi16(0x00FF);
+  const __m256i threshold =
+    _mm256_set1_epi8((char)ampThreshold(sdLaMa091->N));
+  const __m256i factor = _mm256_set1_epi16((short)ampFactor(sdLaMa091->N));
+  const __m256i vmin = _mm256_set1_epi8((char)(uint8_t)sdLaMa091->Vmin);
+  const __m256i vmax = _mm256_set1_epi8((char)(uint8_t)sdLaMa091->Vmax);
+
+  uint32_t j = 0;
+
+  /* Same kernel as updateRowSSE2, the unpacks and the pack being per lane. */
+  for (; j + 32 <= count; j += 32) {
+    __m256i I = _mm256_loadu_si256((const __m256i*)(workImage + j));
+    __m256i M = _mm256_loadu_si256((const __m256i*)(workMt + j));
+    __m256i V = _mm256_loadu_si256((const __m256i*)(workVt + j));
+
+    M = _mm256_max_epu8(_mm256_min_epu8(_mm256_adds_epu8(M, one), I),
+      _mm256_subs_epu8(M, one));
+
+    __m256i D = _mm256_sub_epi8(M, I);
+    __m256i O = _mm256_min_epu8(D, _mm256_sub_epi8(zero, D));
+
+    __m256i big = _mm256_andnot_si256(
+      _mm256_cmpeq_epi8(_mm256_subs_epu8(O, threshold), zero), ones);
+    __m256i ampLo = _mm256_and_si256(
+      _mm256_mullo_epi16(_mm256_unpacklo_epi8(O, zero), factor), lowBytes);
+    __m256i ampHi = _mm256_and_si256(
+      _mm256_mullo_epi16(_mm256_unpackhi_epi8(O, zero), factor), lowBytes);
+    __m256i amp = _mm256_or_si256(_mm256_packus_epi16(ampLo, ampHi), big);
+
+    __m256i wrap = _mm256_and_si256(big, _mm256_cmpeq_epi8(V, ones));
+    V = _mm256_max_epu8(_mm256_min_epu8(_mm256_adds_epu8(V, one), amp),
+      _mm256_subs_epu8(V, one));
+    V = _mm256_andnot_si256(wrap, V);
+    V = _mm256_max_epu8(_mm256_min_epu8(V, vmax), vmin);
+
+    __m256i L = _mm256_cmpeq_epi8(_mm256_max_epu8(O, V), O);
+
+    _mm256_storeu_si256((__m256i*)(workMt + j), M);
+    _mm256_storeu_si256((__m256i*)(workOt + j), O);
+    _mm256_storeu_si256((__m256i*)(workVt + j), V);
+    _mm256_storeu_si256((__m256i*)(labels + j), L);
+  }
+
+  updateRowSSE2(sdLaMa091, workImage + j, workMt + j, workOt + j, workVt + j,
+    labels + j, count - j);
+}
+#endif
+
+static updateRow_t selectUpdateRow(void) {
+#ifdef SDLAMA091_AVX2
+  if (__builtin_cpu_supports("avx2"))
+    return updateRowAVX2;
+#endif
+#ifdef SDLAMA091_SSE2
+  return updateRowSSE2;
+#else
+  return updateRowScalar;
+#endif
+}
+
 sdLaMa091_t* sdLaMa091New(void) {
   sdLaMa091_t* sdLaMa091 = (sdLaMa091_t*) malloc(sizeof(*sdLaMa091));
 
@@ -110,6 +345,7 @@ sdLaMa091_t* sdLaMa091New(void) {
   sdLaMa091->Mt = NULL;
   sdLaMa091->Ot = NULL;
   sdLaMa091->Vt = NULL;
+  sdLaMa091->Lt = NULL;
 
   return sdLaMa091;
 }
@@ -199,6 +435,15 @@ int32_t sdLaMa091AllocInit_8u_C1R(sdLaMa091_t* sdLaMa091,
       workVt += sdLaMa091->unusedBytes;
   }
 
+  /* Labels of the channels of a row, merged into a single-channel map. */
+  sdLaMa091->Lt = (uint8_t*) malloc(sdLaMa091->stride);
+#ifdef DEFENSIVE_ALLOC
+  if (sdLaMa091->Lt == NULL) {
+    outputError("Cannot allocate sdLaMa091->Lt table");
+    return EXIT_FAILURE;
+  }
+#endif
+
   return EXIT_SUCCESS;
 }
 
@@ -375,94 +620,11 @@ int32_t sdLaMa091Update_8u_C1R(sdLaMa091_t* sdLaMa091,
   }
 #endif 
 
-  
-  const uint8_t* workImage = image_data;
-  uint8_t* workMt = sdLaMa091->Mt;
-
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->width; ++j, ++workImage, ++workMt) {
-      if (*workMt < *workImage)
-        ++(*workMt);
-      else if (*workMt > *workImage)
-        --(*workMt);
-    }
-
-    
-    if (sdLaMa091->unusedBytes > 0) {
-      workImage += sdLaMa091->unusedBytes;
-      workMt += sdLaMa091->unusedBytes;
-    }
-  }
-
-  workImage = image_data;
-  workMt = sdLaMa091->Mt;
-  uint8_t* workOt = sdLaMa091->Ot;
+  static const updateRow_t updateRow = selectUpdateRow();
 
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->width; ++j, ++workImage, ++workMt,
-      ++workOt)
-      *workOt = absVal(*workMt - *workImage);
-
-    
-    if (sdLaMa091->unusedBytes > 0) {
-      workImage += sdLaMa091->unusedBytes;
-      workMt += sdLaMa091->unusedBytes;
-      workOt += sdLaMa091->unusedBytes;
-    }
-  }
-
-  
-  workOt = sdLaMa091->Ot;
-  uint8_t* workVt = sdLaMa091->Vt;
-
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->width; ++j, ++workOt, ++workVt) {
-      uint32_t ampOt = sdLaMa091->N * *workOt;
-
-      if (*workVt < ampOt)
-        ++(*workVt);
-      else if (*workVt > ampOt)
-        --(*workVt);
-
-      *workVt = max(min(*workVt, sdLaMa091->Vmax), sdLaMa091->Vmin);
-    }
-
-    
-    if (sdLaMa091->unusedBytes > 0) {
-      workOt += sdLaMa091->unusedBytes;
-      workVt += sdLaMa091->unusedBytes;
-    }
-  }
-
-  
-  workOt = sdLaMa091->Ot;
-  workVt = sdLaMa091->Vt;
-
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->width; ++j, ++segmentation_map,
-      ++workOt, ++workVt) {
-      
-      if (*workOt < *workVt)
-        *segmentation_map = BACKGROUND;
-      else
-        *segmentation_map = FOREGROUND;
-    }
-
-    
-    if (sdLaMa091->unusedBytes > 0) {
-      segmentation_map += sdLaMa091->unusedBytes;
-      workOt += sdLaMa091->unusedBytes;
-      workVt += sdLaMa091->unusedBytes;
-    }
-  }
+  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride)
+    updateRow(sdLaMa091, image_data + i, sdLaMa091->Mt + i, sdLaMa091->Ot + i,
+      sdLaMa091->Vt + i, segmentation_map + i, sdLaMa091->width);
 
   return EXIT_SUCCESS;
 }
@@ -525,113 +687,109 @@ int32_t sdLaMa091Update_8u_C3R(sdLaMa091_t* sdLaMa091,
   }
 #endif 
 
-  
-  const uint8_t* workImage = image_data;
-  uint8_t* workMt = sdLaMa091->Mt;
+  static const updateRow_t updateRow = selectUpdateRow();
 
-  
   for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->rgbWidth; ++j, ++workImage, ++workMt) {
-      if (*workMt < *workImage)
-        ++(*workMt);
-      else if (*workMt > *workImage)
-        --(*workMt);
-    }
+    uint8_t* labels = segmentation_map + i;
 
-    
-    if (sdLaMa091->rgbUnusedBytes > 0) {
-      workImage += sdLaMa091->rgbUnusedBytes;
-      workMt += sdLaMa091->rgbUnusedBytes;
+    updateRow(sdLaMa091, image_data + i, sdLaMa091->Mt + i, sdLaMa091->Ot + i,
+      sdLaMa091->Vt + i, labels, sdLaMa091->rgbWidth);
+
+    /* A pixel is foreground if any of its channels is. */
+    for (uint32_t j = 0; j < sdLaMa091->rgbWidth; j += CHANNELS) {
+      uint8_t label = labels[j + RED] | labels[j + GREEN] | labels[j + BLUE];
+
+      labels[j + RED] = label;
+      labels[j + GREEN] = label;
+      labels[j + BLUE] = label;
     }
   }
 
-  
-  workImage = image_data;
-  workMt = sdLaMa091->Mt;
-  uint8_t* workOt = sdLaMa091->Ot;
+  return EXIT_SUCCESS;
+}
 
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->rgbWidth; ++j, ++workImage, ++workMt,
-      ++workOt)
-      *workOt = absVal(*workMt - *workImage);
+int32_t sdLaMa091Update_8u_C3C1R(sdLaMa091_t* sdLaMa091,
+  const uint8_t* image_data,
+  uint8_t* segmentation_map,
+  const uint32_t map_stride) {
+#ifdef DEFENSIVE_POINTER
+  if (sdLaMa091 == NULL) {
+    outputError("Cannot update a NULL structure");
+    return EXIT_FAILURE;
+  }
 
-    
-    if (sdLaMa091->rgbUnusedBytes > 0) {
-      workImage += sdLaMa091->rgbUnusedBytes;
-      workMt += sdLaMa091->rgbUnusedBytes;
-      workOt += sdLaMa091->rgbUnusedBytes;
-    }
+  if (image_data == NULL) {
+    outputError("Cannot update a structure with a NULL image");
+    return EXIT_FAILURE;
   }
 
-  workOt = sdLaMa091->Ot;
-  uint8_t* workVt = sdLaMa091->Vt;
+  if (segmentation_map == NULL) {
+    outputError("Cannot update a structure with a NULL segmentation map");
+    return EXIT_FAILURE;
+  }
 
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    for (uint32_t j = 0; j < sdLaMa091->rgbWidth; ++j, ++workOt, ++workVt) {
-      uint32_t ampOt = sdLaMa091->N * *workOt;
+  if (sdLaMa091->Mt == NULL) {
+    outputError("Cannot update a structure with a NULL Mt table");
+    return EXIT_FAILURE;
+  }
 
-      if (*workVt < ampOt)
-        ++(*workVt);
-      else if (*workVt > ampOt)
-        --(*workVt);
+  if (sdLaMa091->Ot == NULL) {
+    outputError("Cannot update a structure with a NULL Ot table");
+    return EXIT_FAILURE;
+  }
 
-      *workVt = max(min(*workVt, sdLaMa091->Vmax), sdLaMa091->Vmin);
-    }
+  if (sdLaMa091->Vt == NULL) {
+    outputError("Cannot update a structure with a NULL Vt table");
+    return EXIT_FAILURE;
+  }
 
-    
-    if (sdLaMa091->rgbUnusedBytes > 0) {
-      workOt += sdLaMa091->rgbUnusedBytes;
-      workVt += sdLaMa091->rgbUnusedBytes;
-    }
+  if (sdLaMa091->Lt == NULL) {
+    outputError("Cannot update a structure with a NULL Lt table");
+    return EXIT_FAILURE;
   }
+#endif
 
-  workOt = sdLaMa091->Ot;
-  workVt = sdLaMa091->Vt;
+#ifdef DEFENSIVE_PARAM
+  if (sdLaMa091->imageType != C3R) {
+    outputError("Cannot update a structure which is not C3R");
+    return EXIT_FAILURE;
+  }
 
-  
-  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride) {
-    
-    uint32_t numColor = 0;
-    
-    bool isForeground = false;
+  if (sdLaMa091->rgbWidth == 0 || sdLaMa091->height == 0 ||
+    sdLaMa091->stride == 0) {
+    outputError("Cannot update a structure with zero values");
+    return EXIT_FAILURE;
+  }
 
-    
-    for (uint32_t j = 0; j < sdLaMa091->rgbWidth; ++j, ++workOt, ++workVt) {
-      if (*workOt >= *workVt)
-        isForeground = true;
-
-      
-      if (numColor == BLUE) {
-        if (isForeground) {
-          *segmentation_map = FOREGROUND;
-          *(++segmentation_map) = FOREGROUND;
-          *(++segmentation_map) = FOREGROUND;
-          ++segmentation_map;
-        }
-        else {
-          *segmentation_map = BACKGROUND;
-          *(++segmentation_map) = BACKGROUND;
-          *(++segmentation_map) = BACKGROUND;
-          ++segmentation_map;
-        }
-
-        isForeground = false;
-      }
-
-      numColor = (numColor + 1) % CHANNELS;
-    }
+  if (sdLaMa091->stride < sdLaMa091->rgbWidth) {
+    outputError("Cannot update a structure with a stride lower than the width");
+    return EXIT_FAILURE;
+  }
 
-    
-    if (sdLaMa091->rgbUnusedBytes > 0) {
-      segmentation_map += sdLaMa091->rgbUnusedBytes;
-      workOt += sdLaMa091->rgbUnusedBytes;
-      workVt += sdLaMa091->rgbUnusedBytes;
-    }
+  if (map_stride < sdLaMa091->rgbWidth / CHANNELS) {
+    outputError("Cannot update a map with a stride lower than the width");
+    return EXIT_FAILURE;
+  }
+
+  if (sdLaMa091->Vmax < sdLaMa091->Vmin) {
+    outputError("Cannot update a structure with Vmax inferior to Vmin");
+    return EXIT_FAILURE;
+  }
+#endif 
+
+  static const updateRow_t updateRow = selectUpdateRow();
+
+  uint8_t* labels = sdLaMa091->Lt;
+
+  for (uint32_t i = 0; i < sdLaMa091->numBytes; i += sdLaMa091->stride,
+    segmentation_map += map_stride) {
+    updateRow(sdLaMa091, image_data + i, sdLaMa091->Mt + i, sdLaMa091->Ot + i,
+      sdLaMa091->Vt + i, labels, sdLaMa091->rgbWidth);
+
+    /* A pixel is foreground if any of its channels is. */
+    for (uint32_t j = 0, k = 0; j < sdLaMa091->rgbWidth; j += CHANNELS, ++k)
+      segmentation_map[k] = labels[j + RED] | labels[j + GREEN] |
+        labels[j + BLUE];
   }
 
   return EXIT_SUCCESS;
@@ -651,6 +809,8 @@ int32_t sdLaMa091Free(sdLaMa091_t* sdLaMa091) {
     free(sdLaMa091->Ot);
   if (sdLaMa091->Vt != NULL)
     free(sdLaMa091->Vt);
+  if (sdLaMa091->Lt != NULL)
+    free(sdLaMa091->Lt);
 
   free(sdLaMa091);
 
@@ -67,6 +67,16 @@ int32_t sdLaMa091Update_8u_C3R(sdLaMa091_t* sdLaMa091,
   const uint8_t* image_data,
   uint8_t* segmentation_map);
 
+/*
+ * Same as sdLaMa091Update_8u_C3R, but writes a single-channel segmentation
+ * map of map_stride bytes per row, where a pixel is foreground if any of its
+ * channels is.
+ */
+int32_t sdLaMa091Update_8u_C3C1R(sdLaMa091_t* sdLaMa091,
+  const uint8_t* image_data,
+  uint8_t* segmentation_map,
+  const uint32_t map_stride);
+
 int32_t sdLaMa091Free(sdLaMa091_t* sdLaMa091);
 
 #endif
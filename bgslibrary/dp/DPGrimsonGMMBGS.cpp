@@ -16,14 +16,19 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "DPGrimsonGMMBGS.h"
 
-DPGrimsonGMMBGS::DPGrimsonGMMBGS() : firstTime(true), frameNumber(0), threshold(9.0), alpha(0.01), gaussians(3), showOutput(true) 
+DPGrimsonGMMBGS::DPGrimsonGMMBGS(const DPGrimsonGMMParams& parameters) :
+  firstTime(true), frameNumber(0), threshold(parameters.threshold), alpha(parameters.alpha), gaussians(parameters.gaussians), showOutput(parameters.showOutput)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "DPGrimsonGMMBGS()" << std::endl;
+#endif
 }
 
 DPGrimsonGMMBGS::~DPGrimsonGMMBGS()
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "~DPGrimsonGMMBGS()" << std::endl;
+#endif
 }
 
 void DPGrimsonGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -31,16 +36,24 @@ void DPGrimsonGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv:
   if(img_input.empty())
     return;
 
-  loadConfig();
+  foreground.create(img_input.size(), CV_8UC1);
+  processMask(img_input, foreground);
 
-  if(firstTime)
-    saveConfig();
+#ifndef LABGEN_HEADLESS
+  if(showOutput)
+    cv::imshow("GMM (Grimson)", foreground);
+#endif
+  
+  foreground.copyTo(img_output);
+}
 
-  frame = new IplImage(img_input);
+bool DPGrimsonGMMBGS::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
+{
+  frame = IplImage(img_input);
   
   if(firstTime)
     frame_data.ReleaseMemory(false);
-  frame_data = frame;
+  frame_data = &frame;
 
   if(firstTime)
   {
@@ -50,9 +63,6 @@ void DPGrimsonGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv:
     lowThresholdMask = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
     lowThresholdMask.Ptr()->origin = IPL_ORIGIN_BL;
 
-    highThresholdMask = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
-    highThresholdMask.Ptr()->origin = IPL_ORIGIN_BL;
-
     params.SetFrameSize(width, height);
     params.LowThreshold() = threshold; //3.0f*3.0f;
     params.HighThreshold() = 2*params.LowThreshold();	// Note: high threshold is used by post-processing 
@@ -64,42 +74,16 @@ void DPGrimsonGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv:
     bgs.InitModel(frame_data);
   }
 
+  // the high threshold mask is written straight into the buffer of the caller
+  IplImage mask = IplImage(img_mask);
+  BwImage highThresholdMask(&mask);
+  highThresholdMask.ReleaseMemory(false);
+
   bgs.Subtract(frameNumber, frame_data, lowThresholdMask, highThresholdMask);
   lowThresholdMask.Clear();
   bgs.Update(frameNumber, frame_data, lowThresholdMask);
-  
-  cv::Mat foreground = cv::cvarrToMat(highThresholdMask.Ptr());
 
-  if(showOutput)
-    cv::imshow("GMM (Grimson)", foreground);
-  
-  foreground.copyTo(img_output);
-
-  delete frame;
   firstTime = false;
   frameNumber++;
-}
-
-void DPGrimsonGMMBGS::saveConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPGrimsonGMMBGS.xml", 0, CV_STORAGE_WRITE);
-
-  cvWriteReal(fs, "threshold", threshold);
-  cvWriteReal(fs, "alpha", alpha);
-  cvWriteInt(fs, "gaussians", gaussians);
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
-}
-
-void DPGrimsonGMMBGS::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPGrimsonGMMBGS.xml", 0, CV_STORAGE_READ);
-  
-  threshold = cvReadRealByName(fs, 0, "threshold", 9.0);
-  alpha = cvReadRealByName(fs, 0, "alpha", 0.01);
-  gaussians = cvReadIntByName(fs, 0, "gaussians", 3);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
-
-  cvReleaseFileStorage(&fs);
+  return true;
 }
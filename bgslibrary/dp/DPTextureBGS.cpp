@@ -16,24 +16,28 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "DPTextureBGS.h"
 
-DPTextureBGS::DPTextureBGS() : firstTime(true), showOutput(true)
+DPTextureBGS::DPTextureBGS(const DPTextureParams& parameters) :
+  firstTime(true), showOutput(parameters.showOutput)
   //, enableFiltering(true)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "DPTextureBGS()" << std::endl;
+#endif
 }
 
 DPTextureBGS::~DPTextureBGS()
 {
   delete[] bgModel; // ~10Kb (25.708-15.968)
   delete[] modeArray;
-  delete[] curTextureHist; // ~10Kb (16-6.396)
   //cvReleaseStructuringElement(&dilateElement);
   //cvReleaseStructuringElement(&erodeElement);
   image.ReleaseImage();
   fgMask.ReleaseImage();
   tempMask.ReleaseImage();
   texture.ReleaseImage();
+#ifndef LABGEN_HEADLESS
   std::cout << "~DPTextureBGS()" << std::endl;
+#endif
 }
 
 void DPTextureBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -41,9 +45,20 @@ void DPTextureBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Ma
   if(img_input.empty())
     return;
 
-  loadConfig();
+  img_foreground.create(img_input.size(), CV_8UC1);
+  processMask(img_input, img_foreground);
 
-  frame = new IplImage(img_input);
+  img_foreground.copyTo(img_output);
+  
+#ifndef LABGEN_HEADLESS
+  if(showOutput)
+    cv::imshow("Texture BGS (Donovan Parks)", img_foreground);
+#endif
+}
+
+bool DPTextureBGS::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
+{
+  frame = IplImage(img_input);
   
   if(firstTime)
   {
@@ -53,7 +68,7 @@ void DPTextureBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Ma
 
     // input image
     image = cvCreateImage(cvSize(width, height), 8, 3);
-    cvCopy(frame, image.Ptr());	
+    cvCopy(&frame, image.Ptr());	
 
     // foreground masks
     fgMask = cvCreateImage(cvSize(width, height), 8, 1);
@@ -66,42 +81,22 @@ void DPTextureBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Ma
     texture = cvCreateImage(cvSize(width, height), 8, 3);
     cvZero(texture.Ptr());
     modeArray = new unsigned char[size];
-    curTextureHist = new TextureHistogram[size];
 
     // initialize background model
     bgs.LBP(image, texture);
-    bgs.Histogram(texture, curTextureHist);
-    for(int y = REGION_R+TEXTURE_R; y < height-REGION_R-TEXTURE_R; ++y)
-    {
-      for(int x = REGION_R+TEXTURE_R; x < width-REGION_R-TEXTURE_R; ++x)
-      {
-        int index = x+y*width;
-      
-        for(int m = 0; m < NUM_MODES; ++m)
-        {
-          for(int i = 0; i < NUM_BINS; ++i)
-          {			
-            bgModel[index].mode[m].r[i] = curTextureHist[index].r[i];
-            bgModel[index].mode[m].g[i] = curTextureHist[index].g[i];
-            bgModel[index].mode[m].b[i] = curTextureHist[index].b[i];
-          }
-        }
-      }
-    }
+    bgs.InitModel(texture, bgModel);
 
     //dilateElement = cvCreateStructuringElementEx(7, 7, 3, 3,	CV_SHAPE_RECT);
     //erodeElement = cvCreateStructuringElementEx(3, 3, 1, 1,	CV_SHAPE_RECT);
 
-    saveConfig();
     firstTime = false;
   }
   
-  cvCopy(frame, image.Ptr());	
+  cvCopy(&frame, image.Ptr());	
 
   // perform background subtraction
   bgs.LBP(image, texture);
-  bgs.Histogram(texture, curTextureHist);
-  bgs.BgsCompare(bgModel, curTextureHist, modeArray, THRESHOLD, fgMask);
+  bgs.BgsCompare(bgModel, texture, modeArray, THRESHOLD, fgMask);
   
   //if(enableFiltering)
   //{
@@ -121,36 +116,10 @@ void DPTextureBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Ma
   //}
 
   cv::Mat foreground = cv::cvarrToMat(fgMask.Ptr());
-  if(!foreground.empty())
-    foreground.copyTo(img_output);
-  
-  if(showOutput)
-    cv::imshow("Texture BGS (Donovan Parks)", foreground);
+  foreground.copyTo(img_mask);
 
   // update background subtraction		
-  bgs.UpdateModel(fgMask, bgModel, curTextureHist, modeArray);
-  
-  delete frame;
-}
-
-void DPTextureBGS::saveConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPTextureBGS.xml", 0, CV_STORAGE_WRITE);
-
-  //cvWriteReal(fs, "alpha", alpha);
-  //cvWriteInt(fs, "enableFiltering", enableFiltering);
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
-}
-
-void DPTextureBGS::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPTextureBGS.xml", 0, CV_STORAGE_READ);
-  
-  //alpha = cvReadRealByName(fs, 0, "alpha", 1e-6f);
-  //enableFiltering = cvReadIntByName(fs, 0, "enableFiltering", true);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
+  bgs.UpdateModel(fgMask, bgModel, texture, modeArray);
 
-  cvReleaseFileStorage(&fs);
+  return true;
 }
@@ -21,6 +21,7 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "../IBGS.h"
+#include "../BGSParams.h"
 #include "TextureBGS.h"
 //#include "ConnectedComponents.h"
 
@@ -34,14 +35,14 @@ private:
   int height;
   int size;
   TextureBGS bgs;
-  IplImage* frame;
+  IplImage frame;
   RgbImage image;
   BwImage fgMask;
   BwImage tempMask;
   TextureArray* bgModel;
   RgbImage texture;
   unsigned char* modeArray;
-  TextureHistogram* curTextureHist;
+  cv::Mat img_foreground;
   //ConnectedComponents cc;
   //CBlobResult largeBlobs;
   //IplConvKernel* dilateElement;
@@ -49,12 +50,9 @@ private:
   //bool enableFiltering;
 
 public:
-  DPTextureBGS();
+  DPTextureBGS(const DPTextureParams& parameters = DPTextureParams());
   ~DPTextureBGS();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
-
-private:
-  void saveConfig();
-  void loadConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
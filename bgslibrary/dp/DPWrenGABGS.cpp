@@ -16,14 +16,25 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "DPWrenGABGS.h"
 
-DPWrenGABGS::DPWrenGABGS() : firstTime(true), frameNumber(0), threshold(12.25f), alpha(0.005f), learningFrames(30), showOutput(true)
+DPWrenGABGS::DPWrenGABGS(const DPWrenGAParams& parameters) :
+  firstTime(true), frameNumber(0), threshold(parameters.threshold), alpha(parameters.alpha), learningFrames(parameters.learningFrames), showOutput(parameters.showOutput)
 {
+  // the fixed-point model is a drop-in replacement of the float one
+  if(parameters.fixedPoint)
+    bgs = &fixedBgs;
+  else
+    bgs = &floatBgs;
+
+#ifndef LABGEN_HEADLESS
   std::cout << "DPWrenGABGS()" << std::endl;
+#endif
 }
 
 DPWrenGABGS::~DPWrenGABGS()
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "~DPWrenGABGS()" << std::endl;
+#endif
 }
 
 void DPWrenGABGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -31,16 +42,24 @@ void DPWrenGABGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat
   if(img_input.empty())
     return;
 
-  loadConfig();
+  foreground.create(img_input.size(), CV_8UC1);
+  processMask(img_input, foreground);
 
-  if(firstTime)
-    saveConfig();
+#ifndef LABGEN_HEADLESS
+  if(showOutput)
+    cv::imshow("Gaussian Average (Wren)", foreground);
+#endif
+  
+  foreground.copyTo(img_output);
+}
 
-  frame = new IplImage(img_input);
+bool DPWrenGABGS::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
+{
+  frame = IplImage(img_input);
   
   if(firstTime)
     frame_data.ReleaseMemory(false);
-  frame_data = frame;
+  frame_data = &frame;
 
   if(firstTime)
   {
@@ -50,56 +69,26 @@ void DPWrenGABGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat
     lowThresholdMask = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
     lowThresholdMask.Ptr()->origin = IPL_ORIGIN_BL;
 
-    highThresholdMask = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
-    highThresholdMask.Ptr()->origin = IPL_ORIGIN_BL;
-
     params.SetFrameSize(width, height);
     params.LowThreshold() = threshold; //3.5f*3.5f;
     params.HighThreshold() = 2*params.LowThreshold();	// Note: high threshold is used by post-processing 
     params.Alpha() = alpha; //0.005f;
     params.LearningFrames() = learningFrames; //30;
 
-    bgs.Initalize(params);
-    bgs.InitModel(frame_data);
+    bgs->Initalize(params);
+    bgs->InitModel(frame_data);
   }
 
-  bgs.Subtract(frameNumber, frame_data, lowThresholdMask, highThresholdMask);
-  lowThresholdMask.Clear();
-  bgs.Update(frameNumber, frame_data, lowThresholdMask);
-  
-  cv::Mat foreground = cv::cvarrToMat(highThresholdMask.Ptr());
+  // the high threshold mask is written straight into the buffer of the caller
+  IplImage mask = IplImage(img_mask);
+  BwImage highThresholdMask(&mask);
+  highThresholdMask.ReleaseMemory(false);
 
-  if(showOutput)
-    cv::imshow("Gaussian Average (Wren)", foreground);
-  
-  foreground.copyTo(img_output);
+  bgs->Subtract(frameNumber, frame_data, lowThresholdMask, highThresholdMask);
+  lowThresholdMask.Clear();
+  bgs->Update(frameNumber, frame_data, lowThresholdMask);
 
-  delete frame;
   firstTime = false;
   frameNumber++;
+  return true;
 }
-
-void DPWrenGABGS::saveConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPWrenGABGS.xml", 0, CV_STORAGE_WRITE);
-
-  cvWriteReal(fs, "threshold", threshold);
-  cvWriteReal(fs, "alpha", alpha);
-  cvWriteInt(fs, "learningFrames", learningFrames);
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
-}
-
-void DPWrenGABGS::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPWrenGABGS.xml", 0, CV_STORAGE_READ);
-  
-  threshold = cvReadRealByName(fs, 0, "threshold", 12.25f);
-  alpha = cvReadRealByName(fs, 0, "alpha", 0.005f);
-  learningFrames = cvReadIntByName(fs, 0, "learningFrames", 30);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
-
-  cvReleaseFileStorage(&fs);
-}
-
@@ -21,7 +21,9 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "../IBGS.h"
+#include "../BGSParams.h"
 #include "WrenGA.h"
+#include "WrenGAFixed.h"
 
 using namespace Algorithms::BackgroundSubtraction;
 
@@ -30,27 +32,26 @@ class DPWrenGABGS : public IBGS
 private:
   bool firstTime;
   long frameNumber;
-  IplImage* frame;
+  IplImage frame;
   RgbImage frame_data;
 
   WrenParams params;
-  WrenGA bgs;
+  WrenGA floatBgs;
+  WrenGAFixed fixedBgs;
+  Bgs* bgs;
   BwImage lowThresholdMask;
-  BwImage highThresholdMask;
 
   double threshold;
   double alpha;
   int learningFrames;
   bool showOutput;
+  cv::Mat foreground;
 
 public:
-  DPWrenGABGS();
+  DPWrenGABGS(const DPWrenGAParams& parameters = DPWrenGAParams());
   ~DPWrenGABGS();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
-
-private:
-  void saveConfig();
-  void loadConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
 
@@ -16,14 +16,19 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "DPZivkovicAGMMBGS.h"
 
-DPZivkovicAGMMBGS::DPZivkovicAGMMBGS() : firstTime(true), frameNumber(0), threshold(25.0f), alpha(0.001f), gaussians(3), showOutput(true) 
+DPZivkovicAGMMBGS::DPZivkovicAGMMBGS(const DPZivkovicAGMMParams& parameters) :
+  firstTime(true), frameNumber(0), bgs(parameters.nThreads), threshold(parameters.threshold), alpha(parameters.alpha), gaussians(parameters.gaussians), showOutput(parameters.showOutput)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "DPZivkovicAGMMBGS()" << std::endl;
+#endif
 }
 
 DPZivkovicAGMMBGS::~DPZivkovicAGMMBGS()
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "~DPZivkovicAGMMBGS()" << std::endl;
+#endif
 }
 
 void DPZivkovicAGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -31,16 +36,24 @@ void DPZivkovicAGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, c
   if(img_input.empty())
     return;
 
-  loadConfig();
+  foreground.create(img_input.size(), CV_8UC1);
+  processMask(img_input, foreground);
 
-  if(firstTime)
-    saveConfig();
+#ifndef LABGEN_HEADLESS
+  if(showOutput)
+    cv::imshow("Gaussian Mixture Model (Zivkovic)", foreground);
+#endif
+  
+  foreground.copyTo(img_output);
+}
 
-  frame = new IplImage(img_input);
+bool DPZivkovicAGMMBGS::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
+{
+  frame = IplImage(img_input);
   
   if(firstTime)
     frame_data.ReleaseMemory(false);
-  frame_data = frame;
+  frame_data = &frame;
 
   if(firstTime)
   {
@@ -50,9 +63,6 @@ void DPZivkovicAGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, c
     lowThresholdMask = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
     lowThresholdMask.Ptr()->origin = IPL_ORIGIN_BL;
 
-    highThresholdMask = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
-    highThresholdMask.Ptr()->origin = IPL_ORIGIN_BL;
-
     params.SetFrameSize(width, height);
     params.LowThreshold() = threshold; //5.0f*5.0f;
     params.HighThreshold() = 2*params.LowThreshold();	// Note: high threshold is used by post-processing 
@@ -63,42 +73,16 @@ void DPZivkovicAGMMBGS::process(const cv::Mat &img_input, cv::Mat &img_output, c
     bgs.InitModel(frame_data);
   }
 
+  // the high threshold mask is written straight into the buffer of the caller
+  IplImage mask = IplImage(img_mask);
+  BwImage highThresholdMask(&mask);
+  highThresholdMask.ReleaseMemory(false);
+
   bgs.Subtract(frameNumber, frame_data, lowThresholdMask, highThresholdMask);
   lowThresholdMask.Clear();
   bgs.Update(frameNumber, frame_data, lowThresholdMask);
-  
-  cv::Mat foreground = cv::cvarrToMat(highThresholdMask.Ptr());
 
-  if(showOutput)
-    cv::imshow("Gaussian Mixture Model (Zivkovic)", foreground);
-  
-  foreground.copyTo(img_output);
-
-  delete frame;
   firstTime = false;
   frameNumber++;
-}
-
-void DPZivkovicAGMMBGS::saveConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPZivkovicAGMMBGS.xml", 0, CV_STORAGE_WRITE);
-
-  cvWriteReal(fs, "threshold", threshold);
-  cvWriteReal(fs, "alpha", alpha);
-  cvWriteInt(fs, "gaussians", gaussians);
-  cvWriteInt(fs, "showOutput", showOutput);
-
-  cvReleaseFileStorage(&fs);
-}
-
-void DPZivkovicAGMMBGS::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/DPZivkovicAGMMBGS.xml", 0, CV_STORAGE_READ);
-  
-  threshold = cvReadRealByName(fs, 0, "threshold", 25.0f);
-  alpha = cvReadRealByName(fs, 0, "alpha", 0.001f);
-  gaussians = cvReadIntByName(fs, 0, "gaussians", 3);
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
-
-  cvReleaseFileStorage(&fs);
+  return true;
 }
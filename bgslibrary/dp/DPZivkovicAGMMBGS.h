@@ -21,6 +21,7 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "../IBGS.h"
+#include "../BGSParams.h"
 #include "ZivkovicAGMM.h"
 
 using namespace Algorithms::BackgroundSubtraction;
@@ -30,27 +31,24 @@ class DPZivkovicAGMMBGS : public IBGS
 private:
   bool firstTime;
   long frameNumber;
-  IplImage* frame;
+  IplImage frame;
   RgbImage frame_data;
 
   ZivkovicParams params;
   ZivkovicAGMM bgs;
   BwImage lowThresholdMask;
-  BwImage highThresholdMask;
 
   double threshold;
   double alpha;
   int gaussians;
   bool showOutput;
+  cv::Mat foreground;
 
 public:
-  DPZivkovicAGMMBGS();
+  DPZivkovicAGMMBGS(const DPZivkovicAGMMParams& parameters = DPZivkovicAGMMParams());
   ~DPZivkovicAGMMBGS();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
-
-private:
-  void saveConfig();
-  void loadConfig();
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
 
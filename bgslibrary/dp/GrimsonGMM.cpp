@@ -43,20 +43,16 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "GrimsonGMM.h"
 
+// The pixels are evaluated 4 at a time with SSE2, always available on x86-64
+#if defined(__x86_64__) || defined(_M_X64)
+#define GRIMSON_GMM_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace Algorithms::BackgroundSubtraction;
 
-int compareGMM(const void* _gmm1, const void* _gmm2)
-{
-	GMM gmm1 = *(GMM*)_gmm1;
-	GMM gmm2 = *(GMM*)_gmm2;
-
-	if(gmm1.significants < gmm2.significants)
-		return 1;
-	else if(gmm1.significants == gmm2.significants)
-		return 0;
-	else
-		return -1;
-}
+// Parameters of a Gaussian, in the order of their planes in m_modes
+enum { WEIGHT, VARIANCE, MU_R, MU_G, MU_B, SIGNIFICANTS, NUM_PARAMETERS };
 
 GrimsonGMM::GrimsonGMM()
 {
@@ -79,7 +75,14 @@ void GrimsonGMM::Initalize(const BgsParams& param)
 	m_variance = 36.0f;		// sigma for the new mode
 
 	// GMM for each pixel
-	m_modes = new GMM[m_params.Size()*m_params.MaxModes()];
+	long planes = (long)m_params.Size()*m_params.MaxModes();
+	m_modes = new float[NUM_PARAMETERS*planes];
+	m_weight = m_modes + WEIGHT*planes;
+	m_var = m_modes + VARIANCE*planes;
+	m_muR = m_modes + MU_R*planes;
+	m_muG = m_modes + MU_G*planes;
+	m_muB = m_modes + MU_B*planes;
+	m_significants = m_modes + SIGNIFICANTS*planes;
 
 	// used modes per pixel
 	m_modes_per_pixel = cvCreateImage(cvSize(m_params.Width(), m_params.Height()), IPL_DEPTH_8U, 1);
@@ -96,14 +99,9 @@ void GrimsonGMM::InitModel(const RgbImage& data)
 {
 	m_modes_per_pixel.Clear();
 
-	for(unsigned int i = 0; i < m_params.Size()*m_params.MaxModes(); ++i)
+	for(unsigned int i = 0; i < NUM_PARAMETERS*m_params.Size()*m_params.MaxModes(); ++i)
 	{
-		m_modes[i].weight = 0;
-		m_modes[i].variance = 0;
-		m_modes[i].muR = 0;
-		m_modes[i].muG = 0;
-		m_modes[i].muB = 0;
-		m_modes[i].significants = 0;
+		m_modes[i] = 0;
 	}
 }
 
@@ -112,11 +110,43 @@ void GrimsonGMM::Update(int frame_num, const RgbImage& data,  const BwImage& upd
 	// it doesn't make sense to have conditional updates in the GMM framework
 }
 
+void GrimsonGMM::SwapModes(long pos1, long pos2)
+{
+	long planes = (long)m_params.Size()*m_params.MaxModes();
+
+	for(int i = 0; i < NUM_PARAMETERS; ++i)
+	{
+		float tmp = m_modes[i*planes + pos1];
+		m_modes[i*planes + pos1] = m_modes[i*planes + pos2];
+		m_modes[i*planes + pos2] = tmp;
+	}
+}
+
+void GrimsonGMM::SortModes(long posPixel, int numModes)
+{
+	long size = m_params.Size();
+
+	// Sort significance values so they are in desending order. The sort is stable,
+	// so that modes of equal significance keep their order.
+	for(int i = 1; i < numModes; ++i)
+	{
+		for(int j = i; j > 0; --j)
+		{
+			long pos = posPixel + j*size;
+			if(!(m_significants[pos - size] < m_significants[pos]))
+				break;
+
+			SwapModes(pos - size, pos);
+		}
+	}
+}
+
 void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned char& numModes, 
 																	unsigned char& low_threshold, unsigned char& high_threshold)
 {
 	// calculate distances to the modes (+ sort???)
 	// here we need to go in descending order!!!
+	long size = m_params.Size();
 	long pos;
 	bool bFitsPDF=false;
 	bool bBackgroundLow=false;
@@ -134,7 +164,7 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 		if(sum < m_bg_threshold)
 		{
 			backgroundGaussians++;
-			sum += m_modes[posPixel+i].weight;
+			sum += m_weight[posPixel+i*size];
 		}
 		else
 		{
@@ -145,18 +175,18 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 	// update all distributions and check for match with current pixel
 	for (int iModes=0; iModes < numModes; iModes++)
 	{
-		pos=posPixel+iModes;
-		float weight = m_modes[pos].weight;
+		pos=posPixel+iModes*size;
+		float weight = m_weight[pos];
 
 		// fit not found yet
 		if (!bFitsPDF)
 		{
 			//check if it belongs to some of the modes
 			//calculate distance
-			float var = m_modes[pos].variance;
-			float muR = m_modes[pos].muR;
-			float muG = m_modes[pos].muG;
-			float muB = m_modes[pos].muB;
+			float var = m_var[pos];
+			float muR = m_muR[pos];
+			float muG = m_muG[pos];
+			float muB = m_muB[pos];
 		
 			float dR=muR - pixel(0);
 			float dG=muG - pixel(1);
@@ -180,15 +210,15 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 				//update distribution
 				float k = m_params.Alpha()/weight;
 				weight = fOneMinAlpha*weight + m_params.Alpha();
-				m_modes[pos].weight = weight;
-				m_modes[pos].muR = muR - k*(dR);
-				m_modes[pos].muG = muG - k*(dG);
-				m_modes[pos].muB = muB - k*(dB);
+				m_weight[pos] = weight;
+				m_muR[pos] = muR - k*(dR);
+				m_muG[pos] = muG - k*(dG);
+				m_muB[pos] = muB - k*(dB);
 
 				//limit the variance
 				float sigmanew = var + k*(dist-var);
-				m_modes[pos].variance = sigmanew < 4 ? 4 : sigmanew > 5*m_variance ? 5*m_variance : sigmanew;
-				m_modes[pos].significants = m_modes[pos].weight / sqrt(m_modes[pos].variance);
+				m_var[pos] = sigmanew < 4 ? 4 : sigmanew > 5*m_variance ? 5*m_variance : sigmanew;
+				m_significants[pos] = m_weight[pos] / sqrt(m_var[pos]);
 			}
 			else
 			{
@@ -199,8 +229,8 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 					numModes--;
 				}
 
-				m_modes[pos].weight = weight;
-				m_modes[pos].significants = m_modes[pos].weight / sqrt(m_modes[pos].variance);
+				m_weight[pos] = weight;
+				m_significants[pos] = m_weight[pos] / sqrt(m_var[pos]);
 			}
 		}
 		else
@@ -211,8 +241,8 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 				weight=0.0;
 				numModes--;
 			}
-			m_modes[pos].weight = weight;
-			m_modes[pos].significants = m_modes[pos].weight / sqrt(m_modes[pos].variance);
+			m_weight[pos] = weight;
+			m_significants[pos] = m_weight[pos] / sqrt(m_var[pos]);
 		}
 
 		totalWeight += weight;
@@ -222,13 +252,13 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 	double invTotalWeight = 1.0 / totalWeight;
 	for (int iLocal = 0; iLocal < numModes; iLocal++)
 	{
-		m_modes[posPixel + iLocal].weight *= (float)invTotalWeight;
-		m_modes[posPixel + iLocal].significants = m_modes[posPixel + iLocal].weight 
-																								/ sqrt(m_modes[posPixel + iLocal].variance);
+		pos = posPixel + iLocal*size;
+		m_weight[pos] *= (float)invTotalWeight;
+		m_significants[pos] = m_weight[pos] / sqrt(m_var[pos]);
 	}
 
 	// Sort significance values so they are in desending order. 
-	qsort(&m_modes[posPixel],  numModes, sizeof(GMM), compareGMM);
+	SortModes(posPixel, numModes);
 
 	// make new mode if needed and exit
 	if (!bFitsPDF)
@@ -242,39 +272,39 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 			// the weakest mode will be replaced
 		}
 
-		pos = posPixel + numModes-1;
+		pos = posPixel + (numModes-1)*size;
 		
-		m_modes[pos].muR = pixel.ch[0];
-		m_modes[pos].muG = pixel.ch[1];
-		m_modes[pos].muB = pixel.ch[2];
-		m_modes[pos].variance = m_variance;
-		m_modes[pos].significants = 0;			// will be set below
+		m_muR[pos] = pixel.ch[0];
+		m_muG[pos] = pixel.ch[1];
+		m_muB[pos] = pixel.ch[2];
+		m_var[pos] = m_variance;
+		m_significants[pos] = 0;			// will be set below
 
     if (numModes==1)
-			m_modes[pos].weight = 1;
+			m_weight[pos] = 1;
 		else
-			m_modes[pos].weight = m_params.Alpha();
+			m_weight[pos] = m_params.Alpha();
 
 		//renormalize weights
 		int iLocal;
 		float sum = 0.0;
 		for (iLocal = 0; iLocal < numModes; iLocal++)
 		{
-			sum += m_modes[posPixel+ iLocal].weight;
+			sum += m_weight[posPixel + iLocal*size];
 		}
 
 		double invSum = 1.0/sum;
 		for (iLocal = 0; iLocal < numModes; iLocal++)
 		{
-			m_modes[posPixel + iLocal].weight *= (float)invSum;
-			m_modes[posPixel + iLocal].significants = m_modes[posPixel + iLocal].weight 
-																								/ sqrt(m_modes[posPixel + iLocal].variance);
+			pos = posPixel + iLocal*size;
+			m_weight[pos] *= (float)invSum;
+			m_significants[pos] = m_weight[pos] / sqrt(m_var[pos]);
 
 		}
 	}
 
 	// Sort significance values so they are in desending order. 
-	qsort(&(m_modes[posPixel]), numModes, sizeof(GMM), compareGMM);
+	SortModes(posPixel, numModes);
 
 	if(bBackgroundLow)
 	{
@@ -295,6 +325,253 @@ void GrimsonGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned ch
 	}
 }
 
+#ifdef GRIMSON_GMM_SSE2
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Computes weight / sqrt(variance) with the same rounding as SubtractPixel,
+// whether sqrt resolves there to its float or to its double overload
+static inline __m128 Significance(__m128 weight, __m128 variance)
+{
+	if (sizeof(sqrt(1.0f)) == sizeof(float))
+		return _mm_div_ps(weight, _mm_sqrt_ps(variance));
+
+	__m128d lo = _mm_div_pd(_mm_cvtps_pd(weight), 
+													_mm_sqrt_pd(_mm_cvtps_pd(variance)));
+	__m128d hi = _mm_div_pd(_mm_cvtps_pd(_mm_movehl_ps(weight, weight)), 
+													_mm_sqrt_pd(_mm_cvtps_pd(_mm_movehl_ps(variance, variance))));
+
+	return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+static inline __m128 ModeIsUsed(__m128i numModes, int mode)
+{
+	return _mm_castsi128_ps(_mm_cmpgt_epi32(numModes, _mm_set1_epi32(mode)));
+}
+
+// Odd-even transposition sort of the modes of 4 pixels in desending order of
+// significance. Only modes strictly out of order are exchanged, which keeps the
+// sort stable.
+static void SortLanesModes(float* const* parameters, long posPixel, long size, int maxModes, __m128i numModes)
+{
+	const float* significants = parameters[SIGNIFICANTS];
+
+	for (int round = 0; round < maxModes; round++)
+	{
+		for (int iLocal = round % 2; iLocal + 1 < maxModes; iLocal += 2)
+		{
+			long pos = posPixel + iLocal*size;
+
+			__m128 exchange = _mm_and_ps(ModeIsUsed(numModes, iLocal + 1), 
+				_mm_cmplt_ps(_mm_loadu_ps(significants + pos), _mm_loadu_ps(significants + pos + size)));
+			if (!_mm_movemask_ps(exchange))
+				continue;
+
+			for (int i = 0; i < NUM_PARAMETERS; i++)
+			{
+				__m128 first = _mm_loadu_ps(parameters[i] + pos);
+				__m128 second = _mm_loadu_ps(parameters[i] + pos + size);
+
+				_mm_storeu_ps(parameters[i] + pos, Select(exchange, second, first));
+				_mm_storeu_ps(parameters[i] + pos + size, Select(exchange, first, second));
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Same computations as SubtractPixel, for 4 pixels held in the lanes of SSE2
+// registers. The mode slots are walked for all the lanes: a lane only takes
+// into account the slots below its number of modes, and the first slot it
+// matches. The stable sort of the modes gives the same order as the one of
+// SubtractPixel. Assumes that the weights cannot become negative, i.e. that
+// alpha <= 1.
+///////////////////////////////////////////////////////////////////////////////
+void GrimsonGMM::SubtractPixels(long posPixel, const RgbPixel* pixels, unsigned char* numModes, 
+																		unsigned char* low_threshold, unsigned char* high_threshold)
+{
+	long size = m_params.Size();
+	int maxModes = m_params.MaxModes();
+	float* parameters[NUM_PARAMETERS] = { m_weight, m_var, m_muR, m_muG, m_muB, m_significants };
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1);
+	const __m128 alpha = _mm_set1_ps(m_params.Alpha());
+	const __m128 oneMinAlpha = _mm_set1_ps(1-m_params.Alpha());
+	const __m128 lowThreshold = _mm_set1_ps(m_params.LowThreshold());
+	const __m128 highThreshold = _mm_set1_ps(m_params.HighThreshold());
+	const __m128 minVariance = _mm_set1_ps(4);
+	const __m128 maxVariance = _mm_set1_ps(5*m_variance);
+	const __m128 newVariance = _mm_set1_ps(m_variance);
+	const __m128d bgThreshold = _mm_set1_pd(m_bg_threshold);
+
+	const __m128 pixR = _mm_setr_ps(pixels[0](0), pixels[1](0), pixels[2](0), pixels[3](0));
+	const __m128 pixG = _mm_setr_ps(pixels[0](1), pixels[1](1), pixels[2](1), pixels[3](1));
+	const __m128 pixB = _mm_setr_ps(pixels[0](2), pixels[1](2), pixels[2](2), pixels[3](2));
+
+	__m128i modes = _mm_setr_epi32(numModes[0], numModes[1], numModes[2], numModes[3]);
+
+	__m128 fitsPDF = zero;
+	__m128 backgroundLow = zero;
+	__m128 backgroundHigh = zero;
+	__m128 totalWeight = zero;
+
+	// sum of the weights of the previous modes, in double as in SubtractPixel
+	__m128d sumLo = _mm_setzero_pd();
+	__m128d sumHi = _mm_setzero_pd();
+
+	// update all distributions and check for match with current pixel
+	for (int iModes = 0; iModes < maxModes; iModes++)
+	{
+		__m128 used = ModeIsUsed(modes, iModes);
+		if (!_mm_movemask_ps(used))
+			break;
+
+		long pos = posPixel + iModes*size;
+		__m128 weight = _mm_loadu_ps(m_weight + pos);
+		__m128 var = _mm_loadu_ps(m_var + pos);
+		__m128 muR = _mm_loadu_ps(m_muR + pos);
+		__m128 muG = _mm_loadu_ps(m_muG + pos);
+		__m128 muB = _mm_loadu_ps(m_muB + pos);
+
+		// the Gaussian is part of the background model while the weights of the
+		// previous ones sum below the threshold
+		__m128 background = _mm_and_ps(used, _mm_shuffle_ps(
+			_mm_castpd_ps(_mm_cmplt_pd(sumLo, bgThreshold)), 
+			_mm_castpd_ps(_mm_cmplt_pd(sumHi, bgThreshold)), _MM_SHUFFLE(2, 0, 2, 0)));
+		sumLo = _mm_add_pd(sumLo, _mm_cvtps_pd(weight));
+		sumHi = _mm_add_pd(sumHi, _mm_cvtps_pd(_mm_movehl_ps(weight, weight)));
+
+		__m128 dR = _mm_sub_ps(muR, pixR);
+		__m128 dG = _mm_sub_ps(muG, pixG);
+		__m128 dB = _mm_sub_ps(muB, pixB);
+
+		// calculate the squared distance
+		__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dR, dR), _mm_mul_ps(dG, dG)), _mm_mul_ps(dB, dB));
+
+		// fit not found yet
+		__m128 candidate = _mm_andnot_ps(fitsPDF, used);
+
+		backgroundHigh = _mm_or_ps(backgroundHigh, _mm_and_ps(_mm_and_ps(candidate, background), 
+			_mm_cmplt_ps(dist, _mm_mul_ps(highThreshold, var))));
+
+		__m128 match = _mm_and_ps(candidate, _mm_cmplt_ps(dist, _mm_mul_ps(lowThreshold, var)));
+		backgroundLow = _mm_or_ps(backgroundLow, _mm_and_ps(match, background));
+		fitsPDF = _mm_or_ps(fitsPDF, match);
+
+		//update distribution
+		__m128 k = _mm_div_ps(alpha, weight);
+		__m128 sigmanew = _mm_add_ps(var, _mm_mul_ps(k, _mm_sub_ps(dist, var)));
+		sigmanew = Select(_mm_cmplt_ps(sigmanew, minVariance), minVariance, 
+			Select(_mm_cmpgt_ps(sigmanew, maxVariance), maxVariance, sigmanew));
+
+		weight = Select(match, _mm_add_ps(_mm_mul_ps(oneMinAlpha, weight), alpha), 
+			_mm_mul_ps(oneMinAlpha, weight));
+		muR = Select(match, _mm_sub_ps(muR, _mm_mul_ps(k, dR)), muR);
+		muG = Select(match, _mm_sub_ps(muG, _mm_mul_ps(k, dG)), muG);
+		muB = Select(match, _mm_sub_ps(muB, _mm_mul_ps(k, dB)), muB);
+		var = Select(match, sigmanew, var);
+
+		_mm_storeu_ps(m_weight + pos, Select(used, weight, _mm_loadu_ps(m_weight + pos)));
+		_mm_storeu_ps(m_var + pos, Select(used, var, _mm_loadu_ps(m_var + pos)));
+		_mm_storeu_ps(m_muR + pos, Select(used, muR, _mm_loadu_ps(m_muR + pos)));
+		_mm_storeu_ps(m_muG + pos, Select(used, muG, _mm_loadu_ps(m_muG + pos)));
+		_mm_storeu_ps(m_muB + pos, Select(used, muB, _mm_loadu_ps(m_muB + pos)));
+		_mm_storeu_ps(m_significants + pos, 
+			Select(used, Significance(weight, var), _mm_loadu_ps(m_significants + pos)));
+
+		totalWeight = _mm_add_ps(totalWeight, _mm_and_ps(used, weight));
+	}
+
+	// renormalize weights so they add to one
+	__m128 invTotalWeight = _mm_div_ps(one, totalWeight);
+	for (int iLocal = 0; iLocal < maxModes; iLocal++)
+	{
+		__m128 used = ModeIsUsed(modes, iLocal);
+		if (!_mm_movemask_ps(used))
+			break;
+
+		long pos = posPixel + iLocal*size;
+		__m128 weight = _mm_loadu_ps(m_weight + pos);
+		weight = Select(used, _mm_mul_ps(weight, invTotalWeight), weight);
+
+		_mm_storeu_ps(m_weight + pos, weight);
+		_mm_storeu_ps(m_significants + pos, Select(used, 
+			Significance(weight, _mm_loadu_ps(m_var + pos)), _mm_loadu_ps(m_significants + pos)));
+	}
+
+	// Sort significance values so they are in desending order. 
+	SortLanesModes(parameters, posPixel, size, maxModes, modes);
+
+	// make new mode if needed
+	__m128 create = _mm_andnot_ps(fitsPDF, _mm_castsi128_ps(_mm_cmpeq_epi32(modes, modes)));
+	if (_mm_movemask_ps(create))
+	{
+		// the weakest mode is replaced when all the modes are used
+		__m128i added = _mm_and_si128(_mm_castps_si128(create), 
+			_mm_cmplt_epi32(modes, _mm_set1_epi32(maxModes)));
+		modes = _mm_sub_epi32(modes, added);
+
+		__m128 newWeight = Select(_mm_castsi128_ps(_mm_cmpeq_epi32(modes, _mm_set1_epi32(1))), one, alpha);
+
+		//renormalize weights
+		__m128 sum = zero;
+		for (int iLocal = 0; iLocal < maxModes; iLocal++)
+		{
+			__m128 used = _mm_and_ps(create, ModeIsUsed(modes, iLocal));
+			if (!_mm_movemask_ps(used))
+				break;
+
+			long pos = posPixel + iLocal*size;
+			__m128 replaced = _mm_and_ps(used, _mm_castsi128_ps(_mm_cmpeq_epi32(modes, _mm_set1_epi32(iLocal + 1))));
+			__m128 weight = Select(replaced, newWeight, _mm_loadu_ps(m_weight + pos));
+
+			_mm_storeu_ps(m_weight + pos, weight);
+			_mm_storeu_ps(m_var + pos, Select(replaced, newVariance, _mm_loadu_ps(m_var + pos)));
+			_mm_storeu_ps(m_muR + pos, Select(replaced, pixR, _mm_loadu_ps(m_muR + pos)));
+			_mm_storeu_ps(m_muG + pos, Select(replaced, pixG, _mm_loadu_ps(m_muG + pos)));
+			_mm_storeu_ps(m_muB + pos, Select(replaced, pixB, _mm_loadu_ps(m_muB + pos)));
+
+			sum = _mm_add_ps(sum, _mm_and_ps(used, weight));
+		}
+
+		__m128 invSum = _mm_div_ps(one, sum);
+		for (int iLocal = 0; iLocal < maxModes; iLocal++)
+		{
+			__m128 used = _mm_and_ps(create, ModeIsUsed(modes, iLocal));
+			if (!_mm_movemask_ps(used))
+				break;
+
+			long pos = posPixel + iLocal*size;
+			__m128 weight = _mm_loadu_ps(m_weight + pos);
+			weight = Select(used, _mm_mul_ps(weight, invSum), weight);
+
+			_mm_storeu_ps(m_weight + pos, weight);
+			_mm_storeu_ps(m_significants + pos, Select(used, 
+				Significance(weight, _mm_loadu_ps(m_var + pos)), _mm_loadu_ps(m_significants + pos)));
+		}
+
+		// Sort significance values so they are in desending order. 
+		SortLanesModes(parameters, posPixel, size, maxModes, modes);
+	}
+
+	int lanesModes[4];
+	_mm_storeu_si128((__m128i*)lanesModes, modes);
+
+	int lanesLow = _mm_movemask_ps(backgroundLow);
+	int lanesHigh = _mm_movemask_ps(backgroundHigh);
+
+	for (int i = 0; i < 4; i++)
+	{
+		numModes[i] = (unsigned char)lanesModes[i];
+		low_threshold[i] = (lanesLow & (1 << i)) ? BACKGROUND : FOREGROUND;
+		high_threshold[i] = (lanesHigh & (1 << i)) ? BACKGROUND : FOREGROUND;
+	}
+}
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 //Input:
 //  data - a pointer to the data of a RGB image of the same size
@@ -309,22 +586,47 @@ void GrimsonGMM::Subtract(int frame_num, const RgbImage& data,
 	unsigned char low_threshold, high_threshold;
 	long posPixel;
 
+#ifdef GRIMSON_GMM_SSE2
+	// the weights of the modes cannot vanish with alpha <= 1
+	bool vectorized = 1-m_params.Alpha() >= 0;
+#endif
+
 	// update each pixel of the image
 	for(unsigned int r = 0; r < m_params.Height(); ++r)
 	{
-		for(unsigned int c = 0; c < m_params.Width(); ++c)
+		unsigned int c = 0;
+
+#ifdef GRIMSON_GMM_SSE2
+		if(vectorized)
+		{
+			for(; c + 4 <= m_params.Width(); c += 4)
+			{
+				posPixel=r*m_params.Width()+c;
+
+				SubtractPixels(posPixel, &data(r,c), &m_modes_per_pixel(r,c), 
+												&low_threshold_mask(r,c), &high_threshold_mask(r,c));
+			}
+		}
+#endif
+
+		for(; c < m_params.Width(); ++c)
 		{		
 			// update model + background subtract
-			posPixel=(r*m_params.Width()+c)*m_params.MaxModes();
+			posPixel=r*m_params.Width()+c;
 			
 			SubtractPixel(posPixel, data(r,c), m_modes_per_pixel(r,c), low_threshold, high_threshold);
 			
 			low_threshold_mask(r,c) = low_threshold;
 			high_threshold_mask(r,c) = high_threshold;
+		}
+
+		for(c = 0; c < m_params.Width(); ++c)
+		{
+			posPixel=r*m_params.Width()+c;
 
-			m_background(r,c,0) = (unsigned char)m_modes[posPixel].muR;
-			m_background(r,c,1) = (unsigned char)m_modes[posPixel].muG;
-			m_background(r,c,2) = (unsigned char)m_modes[posPixel].muB;
+			m_background(r,c,0) = (unsigned char)m_muR[posPixel];
+			m_background(r,c,1) = (unsigned char)m_muG[posPixel];
+			m_background(r,c,2) = (unsigned char)m_muB[posPixel];
 		}
 	}
 }
@@ -61,17 +61,6 @@ namespace Algorithms
 {
 	namespace BackgroundSubtraction
 	{
-		typedef struct GMMGaussian
-		{
-			float variance;
-			float muR;
-			float muG;
-			float muB;
-			float weight;
-			float significants;		// this is equal to weight / standard deviation and is used to
-														// determine which Gaussians should be part of the background model
-		} GMM;
-
 		// --- User adjustable parameters used by the Grimson GMM BGS algorithm ---
 		class GrimsonParams : public BgsParams
 		{
@@ -117,10 +106,17 @@ namespace Algorithms
 
 			RgbImage* Background();
 
-		private:	
+		protected:
 			void SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned char& numModes, 
 													unsigned char& lowThreshold, unsigned char& highThreshold);
 
+			// Same as SubtractPixel for 4 consecutive pixels at once
+			void SubtractPixels(long posPixel, const RgbPixel* pixels, unsigned char* numModes, 
+													unsigned char* lowThreshold, unsigned char* highThreshold);
+
+			void SortModes(long posPixel, int numModes);
+			void SwapModes(long pos1, long pos2);
+
 			// User adjustable parameters
 			GrimsonParams m_params;
 
@@ -135,8 +131,17 @@ namespace Algorithms
 			// A simple way is to estimate the typical standard deviation from the images.
 			float m_variance;
 
-			// Dynamic array for the mixture of Gaussians
-			GMM* m_modes;
+			// Dynamic array for the mixture of Gaussians, stored as a structure of arrays:
+			// each parameter is made of MaxModes() planes of Size() values, the i-th plane
+			// holding the i-th mode of every pixel
+			float* m_modes;
+			float* m_weight;
+			float* m_var;
+			float* m_muR;
+			float* m_muG;
+			float* m_muB;
+			float* m_significants;		// this is equal to weight / standard deviation and is used to
+														// determine which Gaussians should be part of the background model
 
 			// Number of Gaussian components per pixel
 			BwImage m_modes_per_pixel;
@@ -16,78 +16,177 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "TextureBGS.h"
 
+/*
+  Unless TEXTURE_BGS_NO_SIMD is defined, the texture codes are computed with
+  SSE2 for 16 bytes (i.e. pixel channels) at a time.
+*/
+#if !defined(TEXTURE_BGS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TEXTURE_BGS_SSE2
+#include <emmintrin.h>
+#endif
+
 TextureBGS::TextureBGS(){}
 TextureBGS::~TextureBGS(){}
 
+// texture code of the byte k of the row center, whose neighbours lie in the
+// rows above2, above1, below1 and below2 (this only works for a texture radius of 2)
+static inline unsigned char TextureCode(const unsigned char* above2, const unsigned char* above1,
+                                        const unsigned char* center, const unsigned char* below1,
+                                        const unsigned char* below2, int k)
+{
+  const int offset = TEXTURE_R*NUM_CHANNELS;
+  unsigned char textureCode = 0;
+  int centerValue = (int)center[k];
+
+  if(centerValue - (int)above2[k] + HYSTERSIS >= 0)
+    textureCode += 1;
+
+  if(centerValue - (int)above1[k-offset] + HYSTERSIS >= 0)
+    textureCode += 2;
+
+  if(centerValue - (int)above1[k+offset] + HYSTERSIS >= 0)
+    textureCode += 4;
+
+  if(centerValue - (int)below1[k-offset] + HYSTERSIS >= 0)
+    textureCode += 8;
+
+  if(centerValue - (int)below1[k+offset] + HYSTERSIS >= 0)
+    textureCode += 16;
+
+  if(centerValue - (int)below2[k] + HYSTERSIS >= 0)
+    textureCode += 32;
+
+  return textureCode;
+}
+
+#ifdef TEXTURE_BGS_SSE2
+// bit of the texture code for the bytes where neighbour <= center+HYSTERSIS,
+// i.e. center-neighbour+HYSTERSIS >= 0 (the saturated sum keeps it true above 255)
+static inline __m128i TextureBit(__m128i centerHysteresis, const unsigned char* neighbour, __m128i bit)
+{
+  __m128i value = _mm_loadu_si128((const __m128i*)neighbour);
+  __m128i lower = _mm_cmpeq_epi8(_mm_min_epu8(value, centerHysteresis), value);
+  return _mm_and_si128(lower, bit);
+}
+#endif
+
 void TextureBGS::LBP(RgbImage& image, RgbImage& texture)
 {
+  const int offset = TEXTURE_R*NUM_CHANNELS;
+  const int firstByte = TEXTURE_R*NUM_CHANNELS;
+  const int endByte = (image.Ptr()->width-TEXTURE_R)*NUM_CHANNELS;
+
   for(int y = TEXTURE_R; y < image.Ptr()->height-TEXTURE_R; ++y)
   {
-    for(int x = TEXTURE_R; x < image.Ptr()->width-TEXTURE_R; ++x)
-    {		
-      for(int ch = 0; ch < NUM_CHANNELS; ++ch)
-      {
-        unsigned char textureCode = 0;
-        int centerValue = (int)image(y, x, ch);
-
-        // this only works for a texture radius of 2
-        if(centerValue - (int)image(y-2, x, ch) + HYSTERSIS >= 0)
-          textureCode += 1;
-
-        if(centerValue - (int)image(y-1, x-2, ch) + HYSTERSIS >= 0)
-          textureCode += 2;
+    const unsigned char* center = &image(y, 0, 0);
+    const unsigned char* above2 = &image(y-2, 0, 0);
+    const unsigned char* above1 = &image(y-1, 0, 0);
+    const unsigned char* below1 = &image(y+1, 0, 0);
+    const unsigned char* below2 = &image(y+2, 0, 0);
+    unsigned char* codes = &texture(y, 0, 0);
 
-        if(centerValue - (int)image(y-1, x+2, ch) + HYSTERSIS >= 0)
-          textureCode += 4;
+    // the channels of a pixel are independent, so the row is processed byte-wise
+    int k = firstByte;
 
-        if(centerValue - (int)image(y+1, x-2, ch) + HYSTERSIS >= 0)
-          textureCode += 8;
+#ifdef TEXTURE_BGS_SSE2
+    const __m128i hysteresis = _mm_set1_epi8(HYSTERSIS);
 
-        if(centerValue - (int)image(y+1, x+2, ch) + HYSTERSIS >= 0)
-          textureCode += 16;
+    for(; k+16 <= endByte; k += 16)
+    {
+      __m128i centerHysteresis = _mm_adds_epu8(_mm_loadu_si128((const __m128i*)(center+k)), hysteresis);
 
-        if(centerValue - (int)image(y+2, x, ch) + HYSTERSIS >= 0)
-          textureCode += 32;
+      __m128i textureCode = TextureBit(centerHysteresis, above2+k, _mm_set1_epi8(1));
+      textureCode = _mm_or_si128(textureCode, TextureBit(centerHysteresis, above1+k-offset, _mm_set1_epi8(2)));
+      textureCode = _mm_or_si128(textureCode, TextureBit(centerHysteresis, above1+k+offset, _mm_set1_epi8(4)));
+      textureCode = _mm_or_si128(textureCode, TextureBit(centerHysteresis, below1+k-offset, _mm_set1_epi8(8)));
+      textureCode = _mm_or_si128(textureCode, TextureBit(centerHysteresis, below1+k+offset, _mm_set1_epi8(16)));
+      textureCode = _mm_or_si128(textureCode, TextureBit(centerHysteresis, below2+k, _mm_set1_epi8(32)));
 
-        texture(y,x,ch) = textureCode;
-      }
+      _mm_storeu_si128((__m128i*)(codes+k), textureCode);
     }
+#endif
+
+    for(; k < endByte; ++k)
+      codes[k] = TextureCode(above2, above1, center, below1, below2, k);
   }
 }
 
-void TextureBGS::Histogram(RgbImage& texture, TextureHistogram* curTextureHist)
+// Calls visit(y, x, histogram) for every pixel far enough from the borders,
+// where histogram is calculated within a 2*REGION_R square. The square slides
+// along the rows: moving to the next pixel removes the column leaving the
+// square and adds the column entering it.
+template <class Visitor>
+static void SlideHistograms(RgbImage& texture, Visitor visit)
 {
-  // calculate histogram within a 2*REGION_R square
+  const int firstX = REGION_R+TEXTURE_R;
+  const int endX = texture.Ptr()->width-REGION_R-TEXTURE_R;
+
+  if(firstX >= endX)
+    return;
+
   for(int y = REGION_R+TEXTURE_R; y < texture.Ptr()->height-REGION_R-TEXTURE_R; ++y)
   {
-    for(int x = REGION_R+TEXTURE_R; x < texture.Ptr()->width-REGION_R-TEXTURE_R; ++x)
-    {	
-      int index = x+y*(texture.Ptr()->width);
+    // clear histogram
+    TextureHistogram hist;
+    for(int i = 0; i < NUM_BINS; ++i)
+    {
+      hist.r[i] = 0;
+      hist.g[i] = 0;
+      hist.b[i] = 0;
+    }
 
-      // clear histogram
-      for(int i = 0; i < NUM_BINS; ++i)
+    // calculate histogram of the first pixel of the row
+    for(int j = -REGION_R; j <= REGION_R; ++j)
+    {
+      for(int i = -REGION_R; i <= REGION_R; ++i)
       {
-        curTextureHist[index].r[i] = 0;
-        curTextureHist[index].g[i] = 0;
-        curTextureHist[index].b[i] = 0;
+        hist.r[texture(y+j,firstX+i,2)]++;
+        hist.g[texture(y+j,firstX+i,1)]++;
+        hist.b[texture(y+j,firstX+i,0)]++;
       }
+    }
+
+    visit(y, firstX, hist);
 
-      // calculate histogram
+    for(int x = firstX+1; x < endX; ++x)
+    {
       for(int j = -REGION_R; j <= REGION_R; ++j)
       {
-        for(int i = -REGION_R; i <= REGION_R; ++i)
-        {
-          curTextureHist[index].r[texture(y+j,x+i,2)]++;
-          curTextureHist[index].g[texture(y+j,x+i,1)]++;
-          curTextureHist[index].b[texture(y+j,x+i,0)]++;
-        }
+        const unsigned char* leaving = &texture(y+j, x-REGION_R-1, 0);
+        const unsigned char* entering = &texture(y+j, x+REGION_R, 0);
+
+        hist.r[leaving[2]]--;
+        hist.g[leaving[1]]--;
+        hist.b[leaving[0]]--;
+
+        hist.r[entering[2]]++;
+        hist.g[entering[1]]++;
+        hist.b[entering[0]]++;
       }
+
+      visit(y, x, hist);
     }
   }
 }
 
-int TextureBGS::ProximityMeasure(TextureHistogram& bgTexture, TextureHistogram& curTextureHist)
+int TextureBGS::ProximityMeasure(const TextureHistogram& bgTexture, const TextureHistogram& curTextureHist)
 {
+#ifdef TEXTURE_BGS_SSE2
+  // intersection of the planes of bins: sum of the minimums, 16 bins at a time
+  const __m128i* bg = (const __m128i*)bgTexture.r;
+  const __m128i* cur = (const __m128i*)curTextureHist.r;
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = zero;
+
+  for(int i = 0; i < NUM_HISTOGRAM_BINS/16; ++i)
+  {
+    __m128i minimum = _mm_min_epu8(_mm_loadu_si128(bg+i), _mm_loadu_si128(cur+i));
+    sum = _mm_add_epi64(sum, _mm_sad_epu8(minimum, zero));
+  }
+
+  return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+#else
   int proximity = 0;	
   for(int i = 0; i < NUM_BINS; ++i)
   {
@@ -97,57 +196,68 @@ int TextureBGS::ProximityMeasure(TextureHistogram& bgTexture, TextureHistogram&
   }
 
   return proximity;	
+#endif
 }
 
-void TextureBGS::BgsCompare(TextureArray* bgModel, TextureHistogram* curTextureHist, 
+void TextureBGS::InitModel(RgbImage& texture, TextureArray* bgModel)
+{
+  const int width = texture.Ptr()->width;
+
+  SlideHistograms(texture, [&](int y, int x, const TextureHistogram& hist)
+  {
+    int index = x+y*width;
+
+    for(int m = 0; m < NUM_MODES; ++m)
+      bgModel[index].mode[m] = hist;
+  });
+}
+
+void TextureBGS::BgsCompare(TextureArray* bgModel, RgbImage& texture, 
                 unsigned char* modeArray, float threshold, BwImage& fgMask)
 {
+  const int width = fgMask.Ptr()->width;
+
   cvZero(fgMask.Ptr());
 
-  for(int y = REGION_R+TEXTURE_R; y < fgMask.Ptr()->height-REGION_R-TEXTURE_R; ++y)
+  SlideHistograms(texture, [&](int y, int x, const TextureHistogram& hist)
   {
-    for(int x = REGION_R+TEXTURE_R; x < fgMask.Ptr()->width-REGION_R-TEXTURE_R; ++x)
-    {	
-      int index = x+y*(fgMask.Ptr()->width);
+    int index = x+y*width;
 
-      // find closest matching texture in background model
-      int maxProximity = -1;
+    // find closest matching texture in background model
+    int maxProximity = -1;
 
-      for(int m = 0; m < NUM_MODES; ++m)
-      {
-        int proximity = ProximityMeasure(bgModel[index].mode[m], curTextureHist[index]);
+    for(int m = 0; m < NUM_MODES; ++m)
+    {
+      int proximity = ProximityMeasure(bgModel[index].mode[m], hist);
 
-        if(proximity > maxProximity)
-        {
-          maxProximity = proximity;
-          modeArray[index] = m;
-        }
+      if(proximity > maxProximity)
+      {
+        maxProximity = proximity;
+        modeArray[index] = m;
       }
-
-      if(maxProximity < threshold)
-        fgMask(y,x) = 255;
     }
-  }
+
+    if(maxProximity < threshold)
+      fgMask(y,x) = 255;
+  });
 }
 
 void TextureBGS::UpdateModel(BwImage& fgMask, TextureArray* bgModel, 
-                 TextureHistogram* curTextureHist, unsigned char* modeArray)
+                 RgbImage& texture, unsigned char* modeArray)
 {
-  for(int y = REGION_R+TEXTURE_R; y < fgMask.Ptr()->height-REGION_R-TEXTURE_R; ++y)
+  const int width = fgMask.Ptr()->width;
+
+  SlideHistograms(texture, [&](int y, int x, const TextureHistogram& hist)
   {
-    for(int x = REGION_R+TEXTURE_R; x < fgMask.Ptr()->width-REGION_R-TEXTURE_R; ++x)
-    {		
-      int index = x+y*(fgMask.Ptr()->width);
+    int index = x+y*width;
 
-      if(fgMask(x,y) == 0)
-      {
-        for(int i = 0; i < NUM_BINS; ++i)
-        {
-          bgModel[index].mode[modeArray[index]].r[i]
-          = (unsigned char)(ALPHA*curTextureHist[index].r[i]
-          + (1-ALPHA)*bgModel[index].mode[modeArray[index]].r[i] + 0.5);
-        }
-      }				
+    // the mask is indexed by (row, column), like everywhere else
+    if(fgMask(y,x) == 0)
+    {
+      TextureHistogram& mode = bgModel[index].mode[modeArray[index]];
+
+      for(int i = 0; i < NUM_BINS; ++i)
+        mode.r[i] = (unsigned char)(ALPHA*hist.r[i] + (1-ALPHA)*mode.r[i] + 0.5);
     }
-  }	
+  });
 }
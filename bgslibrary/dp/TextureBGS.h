@@ -27,6 +27,8 @@ const double THRESHOLD = 0.5*(REGION_R+REGION_R+1)*(REGION_R+REGION_R+1)*NUM_CHA
 const int NUM_MODES = 1;		// The paper describes how multiple modes can be maintained,
 // but this implementation does not fully support more than one
 
+// The bins of the three channels are contiguous, so a histogram is a plane of
+// NUM_HISTOGRAM_BINS bytes processed as a whole by the histogram intersection.
 struct TextureHistogram
 {
   unsigned char r[NUM_BINS];	// histogram for red channel
@@ -34,6 +36,12 @@ struct TextureHistogram
   unsigned char b[NUM_BINS];	// histogram for blue channel
 };
 
+const int NUM_HISTOGRAM_BINS = NUM_CHANNELS*NUM_BINS;
+
+static_assert(sizeof(TextureHistogram) == NUM_HISTOGRAM_BINS,
+              "the bins of a TextureHistogram must be contiguous");
+
+// The modes of a pixel are contiguous planes of bins.
 struct TextureArray
 {
   TextureHistogram mode[NUM_MODES];
@@ -46,10 +54,13 @@ public:
   ~TextureBGS();
 
   void LBP(RgbImage& image, RgbImage& texture);
-  void Histogram(RgbImage& texture, TextureHistogram* curTextureHist);
-  int ProximityMeasure(TextureHistogram& bgTexture, TextureHistogram& curTextureHist);
-  void BgsCompare(TextureArray* bgModel, TextureHistogram* curTextureHist, 
+  int ProximityMeasure(const TextureHistogram& bgTexture, const TextureHistogram& curTextureHist);
+
+  // The following functions compute the histograms of the texture on the fly,
+  // so that they are never stored for the whole frame.
+  void InitModel(RgbImage& texture, TextureArray* bgModel);
+  void BgsCompare(TextureArray* bgModel, RgbImage& texture, 
                 unsigned char* modeArray, float threshold, BwImage& fgMask);
   void UpdateModel(BwImage& fgMask, TextureArray* bgModel, 
-                 TextureHistogram* curTextureHist, unsigned char* modeArray);
+                 RgbImage& texture, unsigned char* modeArray);
 };
@@ -0,0 +1,183 @@
+/*
+This file is part of BGSLibrary.
+
+BGSLibrary is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+BGSLibrary is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/****************************************************************************
+*
+* WrenGAFixed.cpp
+*
+* Purpose: Fixed-point version of the running Gaussian average of WrenGA.
+*          See WrenGAFixed.h for the representation of the model and the
+*          bounds of its deviation from the float model.
+*
+******************************************************************************/
+
+#include "WrenGAFixed.h"
+
+using namespace Algorithms::BackgroundSubtraction;
+
+// Scale a product by alpha (Q0.16) back to the scale of its other factor,
+// rounding to the nearest value.
+static inline int ScaleByAlpha(int alpha, int value)
+{
+	return (int)(((long long)alpha*value + 32768) >> 16);
+}
+
+// Squared distance between a mean and a pixel value, in Q16.8, rounding to
+// the nearest value. The square of 255 << 8 plus the rounding term fits in
+// 32 bits.
+static inline unsigned int SquaredDistance(int delta)
+{
+	unsigned int d = delta < 0 ? -delta : delta;
+	return (d*d + 128) >> 8;
+}
+
+WrenGAFixed::WrenGAFixed()
+{
+	m_gaussian = NULL;
+}
+
+WrenGAFixed::~WrenGAFixed()
+{
+	delete[] m_gaussian;
+}
+
+void WrenGAFixed::Initalize(const BgsParams& param)
+{
+	m_params = (WrenParams&)param;
+
+	float alpha = m_params.Alpha() < 0 ? 0 : m_params.Alpha() > 1 ? 1 : m_params.Alpha();
+	m_alpha = (int)(alpha*65536 + 0.5f);
+
+	m_low_threshold = (long long)(m_params.LowThreshold()*256 + 0.5f);
+	m_high_threshold = (long long)(m_params.HighThreshold()*256 + 0.5f);
+
+	m_variance = 36 << 8;
+	m_min_variance = 4 << 8;
+	m_max_variance = 5*m_variance;
+
+	// Gaussian for each pixel
+	m_gaussian = new GAUSSIAN[m_params.Size()];
+	for(unsigned int i = 0; i < m_params.Size(); ++i)
+	{
+		for(int ch = 0; ch < NUM_CHANNELS; ++ch)
+			m_gaussian[i].mu[ch] = 0;
+		m_gaussian[i].var = 0;
+	}
+
+	m_background = cvCreateImage(cvSize(m_params.Width(), m_params.Height()), IPL_DEPTH_8U, 3);
+}
+
+void WrenGAFixed::InitModel(const RgbImage& data)
+{
+	int pos = 0;
+
+	for(unsigned int r = 0; r < m_params.Height(); ++r)
+	{
+		for(unsigned int c = 0; c < m_params.Width(); ++c)
+		{
+			for(int ch = 0; ch < NUM_CHANNELS; ++ch)
+				m_gaussian[pos].mu[ch] = data(r,c,ch) << 8;
+			m_gaussian[pos].var = m_variance;
+
+			pos++;
+		}
+	}
+}
+
+void WrenGAFixed::Update(int frame_num, const RgbImage& data,  const BwImage& update_mask)
+{
+	int pos = 0;
+
+	for(unsigned int r = 0; r < m_params.Height(); ++r)
+	{
+		for(unsigned int c = 0; c < m_params.Width(); ++c)
+		{
+			// perform conditional updating only if we are passed the learning phase
+			if(update_mask(r,c) == BACKGROUND || frame_num < m_params.LearningFrames())
+			{
+				GAUSSIAN& gaussian = m_gaussian[pos];
+
+				int dR = gaussian.mu[0] - (data(r,c,0) << 8);
+				int dG = gaussian.mu[1] - (data(r,c,1) << 8);
+				int dB = gaussian.mu[2] - (data(r,c,2) << 8);
+
+				int dist = SquaredDistance(dR) + SquaredDistance(dG) + SquaredDistance(dB);
+
+				// the rounded step never exceeds the distance, so the means stay in [0, 255 << 8]
+				gaussian.mu[0] -= ScaleByAlpha(m_alpha, dR);
+				gaussian.mu[1] -= ScaleByAlpha(m_alpha, dG);
+				gaussian.mu[2] -= ScaleByAlpha(m_alpha, dB);
+
+				int sigmanew = gaussian.var + ScaleByAlpha(m_alpha, dist - gaussian.var);
+				gaussian.var = sigmanew < m_min_variance ? m_min_variance : sigmanew > m_max_variance ? m_max_variance : sigmanew;
+
+				m_background(r, c, 0) = (unsigned char)((gaussian.mu[0] + 128) >> 8);
+				m_background(r, c, 1) = (unsigned char)((gaussian.mu[1] + 128) >> 8);
+				m_background(r, c, 2) = (unsigned char)((gaussian.mu[2] + 128) >> 8);
+			}
+
+			pos++;
+		}
+	}
+}
+
+void WrenGAFixed::SubtractPixel(int r, int c, const RgbPixel& pixel,
+																unsigned char& low_threshold,
+																unsigned char& high_threshold)
+{
+	unsigned int pos = r*m_params.Width()+c;
+	const GAUSSIAN& gaussian = m_gaussian[pos];
+
+	// calculate the squared distance between model and pixel, in Q16.8
+	unsigned int dist = 0;
+	for(int ch = 0; ch < NUM_CHANNELS; ++ch)
+		dist += SquaredDistance(gaussian.mu[ch] - (pixel(ch) << 8));
+
+	// compare it to the thresholds times the variance, both sides in Q.16
+	long long scaled_dist = (long long)dist << 8;
+
+	low_threshold = BACKGROUND;
+	high_threshold = BACKGROUND;
+
+	if(scaled_dist > m_low_threshold*gaussian.var)
+		low_threshold = FOREGROUND;
+	if(scaled_dist > m_high_threshold*gaussian.var)
+		high_threshold = FOREGROUND;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//Input:
+//  data - a pointer to the data of a RGB image of the same size
+//Output:
+//  output - a pointer to the data of a gray value image of the same size
+//					(the memory should already be reserved)
+//					values: 255-foreground, 0-background
+///////////////////////////////////////////////////////////////////////////////
+void WrenGAFixed::Subtract(int frame_num, const RgbImage& data,
+														BwImage& low_threshold_mask, BwImage& high_threshold_mask)
+{
+	unsigned char low_threshold, high_threshold;
+
+	for(unsigned int r = 0; r < m_params.Height(); ++r)
+	{
+		for(unsigned int c = 0; c < m_params.Width(); ++c)
+		{
+			SubtractPixel(r, c, data(r,c), low_threshold, high_threshold);
+			low_threshold_mask(r,c) = low_threshold;
+			high_threshold_mask(r,c) = high_threshold;
+		}
+	}
+}
@@ -0,0 +1,117 @@
+/*
+This file is part of BGSLibrary.
+
+BGSLibrary is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+BGSLibrary is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/****************************************************************************
+*
+* WrenGAFixed.h
+*
+* Purpose: Fixed-point version of the running Gaussian average of WrenGA.
+*          It takes the same WrenParams and follows the same update rules,
+*          but the model of a pixel is held in 8 bytes of integers instead
+*          of 24 bytes of floats:
+*
+*          - the means are unsigned Q8.8 values (1/256 of a gray level),
+*          - the variance is an unsigned Q8.8 value (1/256 of a squared gray
+*            level), which holds the clamping range [4, 5*36] of WrenGA,
+*          - alpha is rounded to a Q0.16 value,
+*          - the squared distances are accumulated in Q16.8 in 32 bits.
+*
+*          Every update step is rounded to the nearest representable value,
+*          so the deviation from the float model is bounded as follows, with
+*          a = round(65536*alpha):
+*
+*          - alpha is off by at most 1/131072 (0.15% of the default 0.005),
+*          - a mean stops moving once it is closer than 128/a gray level to
+*            the pixel value (0.39 with the default alpha), whereas the float
+*            mean would keep converging,
+*          - likewise, the variance stops moving once it is closer than 128/a
+*            squared gray level to the squared distance,
+*          - the background image is the mean rounded to the nearest integer,
+*            so it differs by at most 1 from the float background as long as
+*            the means are within half a gray level of each other.
+*
+*          The classification of a pixel can therefore only differ from the
+*          float model when its squared distance lies within these bounds of
+*          the threshold times the variance.
+*
+* Example:
+* Algorithms::BackgroundSubtraction::WrenParams params;
+* ...same parameters as for WrenGA...
+*
+* Algorithms::BackgroundSubtraction::WrenGAFixed bgs;
+* bgs.Initalize(params);
+******************************************************************************/
+
+#ifndef WREN_GA_FIXED_H
+#define WREN_GA_FIXED_H
+
+#include "Bgs.h"
+#include "WrenGA.h"
+
+namespace Algorithms
+{
+  namespace BackgroundSubtraction
+  {
+    // --- Fixed-point mean BGS algorithm ---
+    class WrenGAFixed : public Bgs
+    {
+    private:
+      struct GAUSSIAN
+      {
+        unsigned short mu[NUM_CHANNELS];
+        unsigned short var;
+      };
+
+    public:
+      WrenGAFixed();
+      ~WrenGAFixed();
+
+      void Initalize(const BgsParams& param);
+
+      void InitModel(const RgbImage& data);
+      void Subtract(int frame_num, const RgbImage& data,
+        BwImage& low_threshold_mask, BwImage& high_threshold_mask);
+      void Update(int frame_num, const RgbImage& data,  const BwImage& update_mask);
+
+      RgbImage* Background() { return &m_background; }
+
+    private:
+      void SubtractPixel(int r, int c, const RgbPixel& pixel,
+        unsigned char& lowThreshold, unsigned char& highThreshold);
+
+      WrenParams m_params;
+
+      // Alpha in Q0.16.
+      int m_alpha;
+
+      // Thresholds in Q.8.
+      long long m_low_threshold;
+      long long m_high_threshold;
+
+      // Initial variance and bounds of the variance, in Q8.8.
+      int m_variance;
+      int m_min_variance;
+      int m_max_variance;
+
+      // dynamic array for the Gaussians
+      GAUSSIAN* m_gaussian;
+
+      RgbImage m_background;
+    };
+  }
+}
+
+#endif
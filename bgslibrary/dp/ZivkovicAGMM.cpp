@@ -44,7 +44,8 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 
 using namespace Algorithms::BackgroundSubtraction;
 
-ZivkovicAGMM::ZivkovicAGMM()
+ZivkovicAGMM::ZivkovicAGMM(size_t threads) :
+	m_workers(threads)
 {
 	m_modes = NULL;
 	m_modes_per_pixel = NULL;
@@ -381,13 +382,24 @@ void ZivkovicAGMM::SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned
 ///////////////////////////////////////////////////////////////////////////////
 void ZivkovicAGMM::Subtract(int frame_num, const RgbImage& data,  
 															BwImage& low_threshold_mask, BwImage& high_threshold_mask)
+{
+	// The pixels are independent, so the result does not depend on how the rows
+	// are split.
+	m_workers.parallelForRows(m_params.Height(), [&](size_t firstRow, size_t endRow)
+	{
+		SubtractRows((unsigned int)firstRow, (unsigned int)endRow, data, low_threshold_mask, high_threshold_mask);
+	});
+}
+
+void ZivkovicAGMM::SubtractRows(unsigned int firstRow, unsigned int endRow, const RgbImage& data,  
+																	BwImage& low_threshold_mask, BwImage& high_threshold_mask)
 {
 	unsigned char low_threshold, high_threshold;
 
-	// update each pixel of the image
+	// update each pixel of the rows
 	long posPixel;
-	unsigned char* pUsedModes=m_modes_per_pixel;
-	for(unsigned int r = 0; r < m_params.Height(); ++r)
+	unsigned char* pUsedModes=m_modes_per_pixel + (long)firstRow*m_params.Width();
+	for(unsigned int r = firstRow; r < endRow; ++r)
 	{
 		for(unsigned int c = 0; c < m_params.Width(); ++c)
 		{
@@ -55,6 +55,7 @@ bgs.Initalize(params);
 #define ZIVKOVIC_AGMM_H
 
 #include "Bgs.h"
+#include "../WorkerPool.h"
 
 namespace Algorithms
 {
@@ -103,7 +104,8 @@ namespace Algorithms
       };
 
     public:
-      ZivkovicAGMM();
+      // threads - number of threads subtracting bands of rows of the frames
+      ZivkovicAGMM(size_t threads = 1);
       ~ZivkovicAGMM();
 
       void Initalize(const BgsParams& param);
@@ -119,6 +121,9 @@ namespace Algorithms
       void SubtractPixel(long posPixel, const RgbPixel& pixel, unsigned char* pModesUsed, 
         unsigned char& lowThreshold, unsigned char& highThreshold);
 
+      void SubtractRows(unsigned int firstRow, unsigned int endRow, const RgbImage& data,  
+        BwImage& low_threshold_mask, BwImage& high_threshold_mask);
+
       // User adjustable parameters
       ZivkovicParams m_params;
 
@@ -147,6 +152,9 @@ namespace Algorithms
 
       //number of Gaussian components per pixel
       unsigned char* m_modes_per_pixel;
+
+      // workers subtracting bands of rows in parallel
+      WorkerPool m_workers;
     };
   }
 }
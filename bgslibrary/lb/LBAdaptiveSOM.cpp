@@ -16,16 +16,21 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "LBAdaptiveSOM.h"
 
-LBAdaptiveSOM::LBAdaptiveSOM() : firstTime(true), showOutput(true), 
-  sensitivity(75), trainingSensitivity(245), learningRate(62), trainingLearningRate(255), trainingSteps(55)
+LBAdaptiveSOM::LBAdaptiveSOM(const LBAdaptiveSOMParams& parameters) : firstTime(true), showOutput(parameters.showOutput),
+  sensitivity(parameters.sensitivity), trainingSensitivity(parameters.trainingSensitivity), learningRate(parameters.learningRate),
+  trainingLearningRate(parameters.trainingLearningRate), trainingSteps(parameters.trainingSteps)
 {
+#ifndef LABGEN_HEADLESS
   std::cout << "LBAdaptiveSOM()" << std::endl;
+#endif
 }
 
 LBAdaptiveSOM::~LBAdaptiveSOM()
 {
   delete m_pBGModel;
+#ifndef LABGEN_HEADLESS
   std::cout << "~LBAdaptiveSOM()" << std::endl;
+#endif
 }
 
 void LBAdaptiveSOM::process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel)
@@ -33,77 +38,53 @@ void LBAdaptiveSOM::process(const cv::Mat &img_input, cv::Mat &img_output, cv::M
   if(img_input.empty())
     return;
 
-  loadConfig();
-  
-  IplImage *frame = new IplImage(img_input);
-  
-  if(firstTime)
-  {
-    saveConfig();
-
-    int w = cvGetSize(frame).width;
-    int h = cvGetSize(frame).height;
-
-    m_pBGModel = new BGModelSom(w,h);
-    m_pBGModel->InitModel(frame);
-  }
-  
-  m_pBGModel->setBGModelParameter(0,sensitivity);
-  m_pBGModel->setBGModelParameter(1,trainingSensitivity);
-  m_pBGModel->setBGModelParameter(2,learningRate);
-  m_pBGModel->setBGModelParameter(3,trainingLearningRate);
-  m_pBGModel->setBGModelParameter(5,trainingSteps);
+  img_foreground.create(img_input.size(), CV_8UC1);
+  processMask(img_input, img_foreground);
 
-  m_pBGModel->UpdateModel(frame);
-
-  img_foreground = cv::cvarrToMat(m_pBGModel->GetFG());
   img_background = cv::cvarrToMat(m_pBGModel->GetBG());
     
+#ifndef LABGEN_HEADLESS
   if(showOutput)
   {
     cv::imshow("SOM Mask", img_foreground);
     cv::imshow("SOM Model", img_background);
   }
+#endif
 
   img_foreground.copyTo(img_output);
   img_background.copyTo(img_bgmodel);
-  
-  delete frame;
-  
-  firstTime = false;
 }
 
-//void LBAdaptiveSOM::finish(void)
-//{
-//  delete m_pBGModel;
-//}
-
-void LBAdaptiveSOM::saveConfig()
+bool LBAdaptiveSOM::processMask(const cv::Mat &img_input, cv::Mat &img_mask)
 {
-  CvFileStorage* fs = cvOpenFileStorage("./config/LBAdaptiveSOM.xml", 0, CV_STORAGE_WRITE);
+  frame = IplImage(img_input);
+  
+  if(firstTime)
+  {
+    int w = cvGetSize(&frame).width;
+    int h = cvGetSize(&frame).height;
 
-  cvWriteInt(fs, "sensitivity", sensitivity);
-  cvWriteInt(fs, "trainingSensitivity", trainingSensitivity);
-  cvWriteInt(fs, "learningRate", learningRate);
-  cvWriteInt(fs, "trainingLearningRate", trainingLearningRate);
-  cvWriteInt(fs, "trainingSteps", trainingSteps);
+    m_pBGModel = new BGModelSom(w,h);
+    m_pBGModel->InitModel(&frame);
 
-  cvWriteInt(fs, "showOutput", showOutput);
+    m_pBGModel->setBGModelParameter(0,sensitivity);
+    m_pBGModel->setBGModelParameter(1,trainingSensitivity);
+    m_pBGModel->setBGModelParameter(2,learningRate);
+    m_pBGModel->setBGModelParameter(3,trainingLearningRate);
+    m_pBGModel->setBGModelParameter(5,trainingSteps);
+  }
 
-  cvReleaseFileStorage(&fs);
-}
+  m_pBGModel->UpdateModel(&frame);
 
-void LBAdaptiveSOM::loadConfig()
-{
-  CvFileStorage* fs = cvOpenFileStorage("./config/LBAdaptiveSOM.xml", 0, CV_STORAGE_READ);
+  // the foreground of the model has 3 identical channels
+  cv::Mat foreground = cv::cvarrToMat(m_pBGModel->GetFG());
+  cv::cvtColor(foreground, img_mask, CV_BGR2GRAY);
   
-  sensitivity          = cvReadIntByName(fs, 0, "sensitivity", 75);
-  trainingSensitivity  = cvReadIntByName(fs, 0, "trainingSensitivity", 245);
-  learningRate         = cvReadIntByName(fs, 0, "learningRate", 62);
-  trainingLearningRate = cvReadIntByName(fs, 0, "trainingLearningRate", 255);
-  trainingSteps        = cvReadIntByName(fs, 0, "trainingSteps", 55);
-
-  showOutput = cvReadIntByName(fs, 0, "showOutput", false);
-
-  cvReleaseFileStorage(&fs);
+  firstTime = false;
+  return true;
 }
+
+//void LBAdaptiveSOM::finish(void)
+//{
+//  delete m_pBGModel;
+//}
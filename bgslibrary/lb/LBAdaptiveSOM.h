@@ -23,6 +23,7 @@ along with BGSLibrary.  If not, see <http://www.gnu.org/licenses/>.
 #include "BGModelSom.h"
 
 #include "../IBGS.h"
+#include "../BGSParams.h"
 
 using namespace lb_library;
 using namespace lb_library::AdaptiveSOM;
@@ -32,6 +33,7 @@ class LBAdaptiveSOM : public IBGS
 private:
   bool firstTime;
   bool showOutput;
+  IplImage frame;
   
   BGModel* m_pBGModel;
   int sensitivity;
@@ -44,13 +46,10 @@ private:
   cv::Mat img_background;
 
 public:
-  LBAdaptiveSOM();
+  LBAdaptiveSOM(const LBAdaptiveSOMParams& parameters = LBAdaptiveSOMParams());
   ~LBAdaptiveSOM();
 
   void process(const cv::Mat &img_input, cv::Mat &img_output, cv::Mat &img_bgmodel);
+  bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
   //void finish(void);
-
-private:
-  void saveConfig();
-  void loadConfig();
 };
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include "RandUtils.h"
 #include <iostream>
 #include <opencv2/imgproc/imgproc.hpp>
+#ifndef LABGEN_HEADLESS
 #include <opencv2/highgui/highgui.hpp>
+#endif
 #include <iomanip>
 #include <exception>
 
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
 #include "BackgroundSubtractorLBSP.h"
+#include "RandGenerator.h"
+#include "../WorkerPool.h"
 
 //! defines the default value for BackgroundSubtractorLBSP::m_fRelLBSPThreshold
 #define BGSSUBSENSE_DEFAULT_LBSP_REL_SIMILARITY_THRESHOLD (0.333f)
@@ -14,6 +17,10 @@
 #define BGSSUBSENSE_DEFAULT_REQUIRED_NB_BG_SAMPLES (2)
 //! defines the default value for BackgroundSubtractorSuBSENSE::m_nSamplesForMovingAvgs
 #define BGSSUBSENSE_DEFAULT_N_SAMPLES_FOR_MV_AVGS (100)
+//! defines the default value for BackgroundSubtractorSuBSENSE::m_oWorkers
+#define BGSSUBSENSE_DEFAULT_NB_THREADS (1)
+//! defines the default value for BackgroundSubtractorSuBSENSE::m_nSeed
+#define BGSSUBSENSE_DEFAULT_SEED (0)
 
 /*!
 	Self-Balanced Sensitivity segmenTER (SuBSENSE) change detection algorithm.
@@ -24,7 +31,9 @@
 	For more details on the different parameters or on the algorithm itself, see P.-L. St-Charles et al.,
 	"Flexible Background Subtraction With Self-Balanced Local Sensitivity", in CVPRW 2014.
 
-	This algorithm is currently NOT thread-safe.
+	The frame is processed by horizontal bands on a pool of workers, each band drawing from its own random
+	generator. The bands do not depend on the number of threads, so the results are reproducible for a given
+	seed, whatever the number of threads. An instance is NOT thread-safe.
  */
 class BackgroundSubtractorSuBSENSE : public BackgroundSubtractorLBSP {
 public:
@@ -34,7 +43,9 @@ public:
 									size_t nMinColorDistThreshold=BGSSUBSENSE_DEFAULT_MIN_COLOR_DIST_THRESHOLD,
 									size_t nBGSamples=BGSSUBSENSE_DEFAULT_NB_BG_SAMPLES,
 									size_t nRequiredBGSamples=BGSSUBSENSE_DEFAULT_REQUIRED_NB_BG_SAMPLES,
-									size_t nSamplesForMovingAvgs=BGSSUBSENSE_DEFAULT_N_SAMPLES_FOR_MV_AVGS);
+									size_t nSamplesForMovingAvgs=BGSSUBSENSE_DEFAULT_N_SAMPLES_FOR_MV_AVGS,
+									size_t nThreads=BGSSUBSENSE_DEFAULT_NB_THREADS,
+									uint32_t nSeed=BGSSUBSENSE_DEFAULT_SEED);
 	//! default destructor
 	virtual ~BackgroundSubtractorSuBSENSE();
 	//! (re)initiaization method; needs to be called before starting background subtraction
@@ -110,5 +121,21 @@ protected:
 	cv::Mat m_oLastFGMask_dilated_inverted;
 	cv::Mat m_oCurrRawFGBlinkMask;
 	cv::Mat m_oLastRawFGBlinkMask;
+
+	//! seed of the random generators
+	const uint32_t m_nSeed;
+	//! workers processing the horizontal bands of the frames
+	WorkerPool m_oWorkers;
+	//! index in m_aPxIdxLUT of the first relevant pixel of each band, followed by the end of the last band
+	std::vector<size_t> m_vnBandModelIdx;
+	//! random generator of each band
+	std::vector<RandGenerator> m_voBandGenerators;
+	//! random generator of the model refreshes
+	RandGenerator m_oRefreshGenerator;
+	//! number of non-zero descriptors found by each band in the last frame
+	std::vector<size_t> m_vnBandNonZeroDescCount;
+
+	//! processes the relevant pixels of a band; the bands processed concurrently must be two apart
+	void processBand(size_t nBand, const cv::Mat& oInputImg, cv::Mat& oCurrFGMask, float fRollAvgFactor_LT, float fRollAvgFactor_ST, double learningRateOverride);
 };
 
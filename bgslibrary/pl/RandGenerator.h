@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+/*!
+	Small seedable pseudo-random generator (PCG32, XSH-RR variant, see M. E. O'Neill, "PCG: A Family of Simple
+	Fast Space-Efficient Statistically Good Algorithms for Random Number Generation", 2014).
+
+	Unlike rand(), it holds its own state, so that each thread (or each band of a frame) can draw from its own
+	generator without any lock, and the results only depend on the seed. Generators with the same seed but
+	distinct streams give independent sequences.
+ */
+class RandGenerator {
+public:
+	//! seeds the generator with the given seed and stream
+	explicit RandGenerator(uint64_t nSeed=0, uint64_t nStream=0) {
+		seed(nSeed,nStream);
+	}
+	//! reseeds the generator with the given seed and stream
+	inline void seed(uint64_t nSeed, uint64_t nStream=0) {
+		m_nState = 0;
+		m_nIncrement = (nStream<<1)|1;
+		(*this)();
+		m_nState += nSeed;
+		(*this)();
+	}
+	//! returns a uniformly distributed 32-bit value
+	inline uint32_t operator()() {
+		const uint64_t nOldState = m_nState;
+		m_nState = nOldState*6364136223846793005ULL+m_nIncrement;
+		const uint32_t nXorShifted = (uint32_t)(((nOldState>>18)^nOldState)>>27);
+		const uint32_t nRotation = (uint32_t)(nOldState>>59);
+		return (nXorShifted>>nRotation)|(nXorShifted<<((32-nRotation)&31));
+	}
+	//! returns a value in [0,nBound), scaling a 32-bit draw with a multiply-shift instead of a modulo
+	inline uint32_t bounded(uint32_t nBound) {
+		return (uint32_t)(((uint64_t)(*this)()*nBound)>>32);
+	}
+
+private:
+	uint64_t m_nState;
+	uint64_t m_nIncrement;
+};
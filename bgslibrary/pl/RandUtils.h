@@ -1,5 +1,7 @@
 #pragma once
 
+#include "RandGenerator.h"
+
 /*// gaussian 3x3 pattern, based on 'floor(fspecial('gaussian', 3, 1)*256)'
 static const int s_nSamplesInitPatternWidth = 3;
 static const int s_nSamplesInitPatternHeight = 3;
@@ -24,9 +26,9 @@ static const int s_anSamplesInitPattern[s_nSamplesInitPatternHeight][s_nSamplesI
     {2,     4,     6,     7,     6,     4,     2,},
 };
 
-//! returns a random init/sampling position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-static inline void getRandSamplePosition(int& x_sample, int& y_sample, const int x_orig, const int y_orig, const int border, const cv::Size& imgsize) {
-    int r = 1+rand()%s_nSamplesInitPatternTot;
+//! returns a random init/sampling position for the specified pixel position, drawn from the given generator; also guards against out-of-bounds values via image/border size check.
+static inline void getRandSamplePosition(RandGenerator& oGen, int& x_sample, int& y_sample, const int x_orig, const int y_orig, const int border, const cv::Size& imgsize) {
+    int r = 1+(int)oGen.bounded(s_nSamplesInitPatternTot);
     for(x_sample=0; x_sample<s_nSamplesInitPatternWidth; ++x_sample) {
         for(y_sample=0; y_sample<s_nSamplesInitPatternHeight; ++y_sample) {
             r -= s_anSamplesInitPattern[y_sample][x_sample];
@@ -55,9 +57,9 @@ static const int s_anNeighborPattern_3x3[8][2] = {
     {-1,-1},  { 0,-1},  { 1,-1},
 };
 
-//! returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-static inline void getRandNeighborPosition_3x3(int& x_neighbor, int& y_neighbor, const int x_orig, const int y_orig, const int border, const cv::Size& imgsize) {
-    int r = rand()%s_anNeighborPatternSize_3x3;
+//! returns a random neighbor position for the specified pixel position, drawn from the given generator; also guards against out-of-bounds values via image/border size check.
+static inline void getRandNeighborPosition_3x3(RandGenerator& oGen, int& x_neighbor, int& y_neighbor, const int x_orig, const int y_orig, const int border, const cv::Size& imgsize) {
+    int r = (int)oGen.bounded(s_anNeighborPatternSize_3x3);
     x_neighbor = x_orig+s_anNeighborPattern_3x3[r][0];
     y_neighbor = y_orig+s_anNeighborPattern_3x3[r][1];
     if(x_neighbor<border)
@@ -80,9 +82,9 @@ static const int s_anNeighborPattern_5x5[24][2] = {
     {-2,-2},  {-1,-2},  { 0,-2},  { 1,-2},  { 2,-2},
 };
 
-//! returns a random neighbor position for the specified pixel position; also guards against out-of-bounds values via image/border size check.
-static inline void getRandNeighborPosition_5x5(int& x_neighbor, int& y_neighbor, const int x_orig, const int y_orig, const int border, const cv::Size& imgsize) {
-    int r = rand()%s_anNeighborPatternSize_5x5;
+//! returns a random neighbor position for the specified pixel position, drawn from the given generator; also guards against out-of-bounds values via image/border size check.
+static inline void getRandNeighborPosition_5x5(RandGenerator& oGen, int& x_neighbor, int& y_neighbor, const int x_orig, const int y_orig, const int border, const cv::Size& imgsize) {
+    int r = (int)oGen.bounded(s_anNeighborPatternSize_5x5);
     x_neighbor = x_orig+s_anNeighborPattern_5x5[r][0];
     y_neighbor = y_orig+s_anNeighborPattern_5x5[r][1];
     if(x_neighbor<border)
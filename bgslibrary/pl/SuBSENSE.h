@@ -3,6 +3,7 @@
 #include <opencv2/opencv.hpp>
 
 #include "../IBGS.h"
+#include "../BGSParams.h"
 
 class BackgroundSubtractorSuBSENSE;
 
@@ -18,15 +19,14 @@ private:
 	size_t nBGSamples;
 	size_t nRequiredBGSamples;
 	size_t nSamplesForMovingAvgs;
+	size_t nThreads;
+	uint32_t nSeed;
 
 public:
-	SuBSENSEBGS();
+	SuBSENSEBGS(const SuBSENSEParams& parameters = SuBSENSEParams());
 	~SuBSENSEBGS();
 
 	void process(const cv::Mat &img_input, cv::Mat &img_output,
 			cv::Mat &img_bgmodel);
-
-private:
-	void saveConfig();
-	void loadConfig();
+	bool processMask(const cv::Mat &img_input, cv::Mat &img_mask);
 };
@@ -45,6 +45,10 @@ namespace ns_labgen {
       int32_t s_param;
       int32_t n_param;
       int32_t p_param;
+      bool incremental;
+      int32_t threads;
+      bool pipelined;
+      uint32_t seed;
       bool visualization;
       bool split_vis;
       bool record;
@@ -77,6 +81,14 @@ namespace ns_labgen {
 
       int32_t get_p_param() const;
 
+      bool get_incremental() const;
+
+      int32_t get_threads() const;
+
+      bool get_pipelined() const;
+
+      uint32_t get_seed() const;
+
       bool get_visualization() const;
 
       bool get_split_vis() const;
@@ -119,6 +131,14 @@ namespace ns_labgen {
 
       void parse_p_param();
 
+      void parse_incremental();
+
+      void parse_threads();
+
+      void parse_pipelined();
+
+      void parse_seed();
+
       void parse_visualization();
 
       void parse_split_vis();
@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 
+#include <BGSParams.h>
 #include <IBGS.h>
 
 namespace ns_labgen {
@@ -34,7 +35,10 @@ namespace ns_labgen {
     class BGSFactory {
       public:
 
-        static std::shared_ptr<IBGS> get_bgs_algorithm(std::string algorithm);
+        static std::shared_ptr<IBGS> get_bgs_algorithm(
+          std::string algorithm,
+          const BGSParams& params = BGSParams()
+        );
     };
   } /* ns_internals */
 } /* ns_labgen */
@@ -0,0 +1,95 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#if defined(LABGEN_HEADLESS) && (OPENCV_VERSION != 2)
+#include <opencv2/videoio/videoio.hpp>
+#include <opencv2/videoio/videoio_c.h>
+#else
+#include <opencv2/highgui/highgui.hpp>
+#endif
+
+namespace ns_labgen {
+  /* ======================================================================== *
+   * FrameSource                                                              *
+   * ======================================================================== */
+
+  /*
+   * Gives access to the frames of a sequence by index without keeping the
+   * whole sequence in memory. Frames are decoded on demand: sequential reads
+   * come straight from the decoder, and reads going backward (as required by
+   * the back-and-forth passes of the P parameter) are served from a bounded
+   * cache that is refilled by seeking and re-decoding a chunk of frames.
+   */
+  class FrameSource {
+    public:
+
+      typedef std::vector<cv::Mat>                                  FramesVec;
+
+    public:
+
+      static const size_t DEFAULT_CACHE_SIZE;
+
+    protected:
+
+      std::string input;
+      cv::VideoCapture decoder;
+      int32_t height;
+      int32_t width;
+      size_t position;
+      size_t frames_count;
+      bool frames_count_known;
+      FramesVec cache;
+      size_t cache_begin;
+      size_t cache_end;
+
+    public:
+
+      explicit FrameSource(
+        const std::string& input,
+        size_t cache_size = DEFAULT_CACHE_SIZE
+      );
+
+      bool read(size_t index, cv::Mat& frame);
+
+      int32_t get_height() const;
+
+      int32_t get_width() const;
+
+      bool is_size_known() const;
+
+      size_t size() const;
+
+    protected:
+
+      void open();
+
+      void seek(size_t index);
+
+      void fill_cache(size_t index);
+  };
+} /* ns_labgen */
@@ -26,41 +26,39 @@
 
 #include <opencv2/core/core.hpp>
 
+#include "Median.hpp"
+#include "ThreadPool.hpp"
 #include "Utils.hpp"
 
 namespace ns_labgen {
   namespace ns_internals {
     /* ====================================================================== *
-     * HistoryMat                                                             *
+     * HistoryEntry                                                           *
      * ====================================================================== */
 
-    class HistoryMat {
-        friend bool operator< (const HistoryMat& lhs, const HistoryMat& rhs);
-        friend bool operator<=(const HistoryMat& lhs, const HistoryMat& rhs);
-        friend bool operator==(const HistoryMat& lhs, const HistoryMat& rhs);
-        friend bool operator< (const HistoryMat& lhs, const uint32_t&   rhs);
-        friend bool operator<=(const HistoryMat& lhs, const uint32_t&   rhs);
-        friend bool operator==(const HistoryMat& lhs, const uint32_t&   rhs);
-        friend bool operator< (const uint32_t&   lhs, const HistoryMat& rhs);
-        friend bool operator<=(const uint32_t&   lhs, const HistoryMat& rhs);
-        friend bool operator==(const uint32_t&   lhs, const HistoryMat& rhs);
+    class HistoryEntry {
+        friend bool operator< (const HistoryEntry& lhs, const HistoryEntry& rhs);
+        friend bool operator<=(const HistoryEntry& lhs, const HistoryEntry& rhs);
+        friend bool operator==(const HistoryEntry& lhs, const HistoryEntry& rhs);
+        friend bool operator< (const HistoryEntry& lhs, const uint32_t&     rhs);
+        friend bool operator<=(const HistoryEntry& lhs, const uint32_t&     rhs);
+        friend bool operator==(const HistoryEntry& lhs, const uint32_t&     rhs);
+        friend bool operator< (const uint32_t&     lhs, const HistoryEntry& rhs);
+        friend bool operator<=(const uint32_t&     lhs, const HistoryEntry& rhs);
+        friend bool operator==(const uint32_t&     lhs, const HistoryEntry& rhs);
 
       protected:
 
-        cv::Mat mat;
+        size_t slot;
         uint32_t positives;
 
       public:
 
-        HistoryMat(const cv::Mat& mat, const uint32_t positives);
+        HistoryEntry(size_t slot, const uint32_t positives);
 
-        HistoryMat(const HistoryMat& copy);
+        size_t get_slot() const;
 
-        HistoryMat& operator=(const HistoryMat& copy);
-
-        cv::Mat& operator*();
-
-        const cv::Mat& operator*() const;
+        uint32_t get_positives() const;
     };
 
     /* ====================================================================== *
@@ -68,71 +66,222 @@ namespace ns_labgen {
      * ====================================================================== */
 
     struct HistoryInterface {
+      virtual ~HistoryInterface() {}
+
       virtual void insert(
         const cv::Mat& segmentation_map,
         const cv::Mat& current_frame
       ) = 0;
 
-      virtual void median(cv::Mat& result, size_t size) const = 0;
+      virtual void median(cv::Mat& result, size_t size) = 0;
+
+      /*
+       * Same as median, but result is expected to hold the output of the
+       * previous refresh, so that only what changed since then is computed.
+       */
+      virtual void refresh(cv::Mat& result, size_t size) = 0;
+
+      virtual bool empty() const = 0;
     };
 
     /* ====================================================================== *
      * History                                                                *
      * ====================================================================== */
 
+    /*
+     * The patches of the history are stored in a slab of buffer_size slots
+     * allocated once. The history itself is a small vector of entries sorted
+     * by number of positives, each one referring to the slot of its patch.
+     * The scratch buffers of the median belong to the instance, so distinct
+     * histories can compute their median concurrently. A history is dirty
+     * when it changed since its last refresh. As the slots are headers into
+     * the slab, a history cannot be copied, but it can be moved.
+     */
     class History : public HistoryInterface {
       public:
-        typedef std::vector<HistoryMat>                             HistoryVec;
+        typedef std::vector<HistoryEntry>                           HistoryVec;
+        typedef std::vector<cv::Mat>                                  SlotsVec;
+        typedef std::vector<size_t>                               FreeSlotsVec;
+        typedef std::vector<unsigned char>                          SamplesVec;
 
       protected:
 
         HistoryVec history;
         size_t buffer_size;
+        cv::Mat slab;
+        SlotsVec slots;
+        FreeSlotsVec free_slots;
+        bool incremental;
+        MedianHistograms histograms;
+        SamplesVec buffer_r;
+        SamplesVec buffer_g;
+        SamplesVec buffer_b;
+        bool dirty;
+        size_t refreshed_size;
 
       public:
 
-      explicit History(size_t buffer_size);
+      History(
+        size_t buffer_size,
+        const cv::Size& patch_size,
+        bool incremental = false
+      );
+
+      History(const History&) = delete;
+
+      History(History&&) = default;
+
+      History& operator=(const History&) = delete;
+
+      History& operator=(History&&) = default;
 
       HistoryVec& operator*();
 
       const HistoryVec& operator*() const;
 
+      const cv::Mat& get_patch(size_t rank) const;
+
       virtual void insert(
         const cv::Mat& segmentation_map,
         const cv::Mat& current_frame
       ) override;
 
-      virtual void median(cv::Mat& result, size_t size) const override;
+      void insert(uint32_t positives, const cv::Mat& current_frame);
+
+      virtual void median(cv::Mat& result, size_t size) override;
+
+      virtual void refresh(cv::Mat& result, size_t size) override;
+
+      virtual bool empty() const override;
 
-      bool empty() const;
+      bool is_incremental() const;
+
+      protected:
+
+      void account(const cv::Mat& patch, bool added);
     };
 
     /* ====================================================================== *
      * PatchesHistory                                                         *
      * ====================================================================== */
 
+    /*
+     * The positives of all the patches are counted in a single pass over the
+     * segmentation map, which fills a summed-area table. The count of a patch
+     * is then read from the four corners of its ROI.
+     */
     class PatchesHistory : public HistoryInterface {
       public:
 
         typedef std::vector<History>                         PatchesHistoryVec;
+        typedef std::vector<uint32_t>                             IntegralVec;
 
       protected:
 
         PatchesHistoryVec p_history;
         Utils::ROIs rois;
+        ThreadPool pool;
+        size_t integral_height;
+        size_t integral_width;
+        IntegralVec integral;
 
       public:
 
-        PatchesHistory(const Utils::ROIs& rois, size_t buffer_size);
+        PatchesHistory(
+          const Utils::ROIs& rois,
+          size_t buffer_size,
+          bool incremental = false,
+          size_t threads = 1
+        );
 
         virtual void insert(
           const cv::Mat& segmentation_map,
           const cv::Mat& current_frame
         ) override;
 
-        virtual void median(cv::Mat& result, size_t size) const override;
+        virtual void median(cv::Mat& result, size_t size) override;
+
+        virtual void refresh(cv::Mat& result, size_t size) override;
+
+        virtual bool empty() const override;
+
+      protected:
+
+        void count_positives(const cv::Mat& segmentation_map);
+
+        uint32_t get_positives(const cv::Rect& roi) const;
+    };
+
+    /* ====================================================================== *
+     * PixelsHistory                                                          *
+     * ====================================================================== */
+
+    /*
+     * Pixel-level history (N = 0) stored as structure of arrays: the samples
+     * and the priorities of the i-th slot of every pixel lie in flat planes.
+     * With 1x1 patches, the number of positives of a sample is 0 or 1, so the
+     * order of the history of a pixel is fully described by a priority
+     * combining the label of the sample and its insertion time. The samples
+     * sorted by increasing priority are in the order of the patch-based
+     * history, and the sample to evict is the one of highest priority.
+     */
+    class PixelsHistory : public HistoryInterface {
+      public:
+
+        typedef std::vector<unsigned char>                          SamplesVec;
+        typedef std::vector<uint32_t>                            PrioritiesVec;
+        typedef std::vector<uint32_t>                                 SlotsVec;
+
+      protected:
+
+        static const uint32_t POSITIVE_FLAG;
+
+        static const uint32_t MAX_STAMP;
+
+      protected:
+
+        size_t height;
+        size_t width;
+        size_t pixels;
+        size_t buffer_size;
+        size_t count;
+        uint32_t stamp;
+        SamplesVec samples;
+        PrioritiesVec priorities;
+        PrioritiesVec worst_priorities;
+        SlotsVec worst_slots;
+        bool incremental;
+        MedianHistograms histograms;
+        SamplesVec buffer_r;
+        SamplesVec buffer_g;
+        SamplesVec buffer_b;
+        SlotsVec ranking;
+
+      public:
+
+        PixelsHistory(
+          size_t height,
+          size_t width,
+          size_t buffer_size,
+          bool incremental = false
+        );
+
+        virtual void insert(
+          const cv::Mat& segmentation_map,
+          const cv::Mat& current_frame
+        ) override;
+
+        virtual void median(cv::Mat& result, size_t size) override;
+
+        virtual void refresh(cv::Mat& result, size_t size) override;
+
+        virtual bool empty() const override;
+
+      protected:
+
+        void find_worst_slots();
 
-        bool empty() const;
+        void rank_slots(size_t pixel, size_t size);
     };
 
 #define _NS_LABGEN_NS_INTERNALS_HISTORY_IPP_
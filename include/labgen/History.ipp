@@ -25,55 +25,55 @@
  * Operator(s) overloading                                                    *
  ******************************************************************************/
 
-inline bool operator<(const HistoryMat& lhs, const HistoryMat& rhs) {
+inline bool operator<(const HistoryEntry& lhs, const HistoryEntry& rhs) {
   return lhs.positives < rhs.positives;
 }
 
 /******************************************************************************/
 
-inline bool operator<=(const HistoryMat& lhs, const HistoryMat& rhs) {
+inline bool operator<=(const HistoryEntry& lhs, const HistoryEntry& rhs) {
   return lhs.positives <= rhs.positives;
 }
 
 /******************************************************************************/
 
-inline bool operator==(const HistoryMat& lhs, const HistoryMat& rhs) {
+inline bool operator==(const HistoryEntry& lhs, const HistoryEntry& rhs) {
   return lhs.positives == rhs.positives;
 }
 
 /******************************************************************************/
 
-inline bool operator<(const HistoryMat& lhs, const uint32_t& rhs) {
+inline bool operator<(const HistoryEntry& lhs, const uint32_t& rhs) {
   return lhs.positives < rhs;
 }
 
 /******************************************************************************/
 
-inline bool operator<=(const HistoryMat& lhs, const uint32_t& rhs) {
+inline bool operator<=(const HistoryEntry& lhs, const uint32_t& rhs) {
   return lhs.positives <= rhs;
 }
 
 /******************************************************************************/
 
-inline bool operator==(const HistoryMat& lhs, const uint32_t& rhs) {
+inline bool operator==(const HistoryEntry& lhs, const uint32_t& rhs) {
   return lhs.positives == rhs;
 }
 
 /******************************************************************************/
 
-inline bool operator<(const uint32_t& lhs, const HistoryMat& rhs) {
+inline bool operator<(const uint32_t& lhs, const HistoryEntry& rhs) {
   return lhs < rhs.positives;
 }
 
 /******************************************************************************/
 
-inline bool operator<=(const uint32_t& lhs, const HistoryMat& rhs) {
+inline bool operator<=(const uint32_t& lhs, const HistoryEntry& rhs) {
   return lhs <= rhs.positives;
 }
 
 /******************************************************************************/
 
-inline bool operator==(const uint32_t& lhs, const HistoryMat& rhs) {
+inline bool operator==(const uint32_t& lhs, const HistoryEntry& rhs) {
   return lhs == rhs.positives;
 }
 #endif /* _NS_LABGEN_NS_INTERNALS_HISTORY_IPP_ */
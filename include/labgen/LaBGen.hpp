@@ -24,19 +24,36 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <opencv2/core/core.hpp>
 
+#include <BGSParams.h>
 #include <IBGS.h>
 
 #include "History.hpp"
+#include "Pipeline.hpp"
 
 namespace ns_labgen {
   /* ======================================================================== *
    * LaBGen                                                                   *
    * ======================================================================== */
 
+  /*
+   * When pipelined, the background subtraction of a frame overlaps the
+   * insertion of the previous ones into the history, which is performed by a
+   * dedicated thread. Each slot of the pipeline owns a copy of its frame and
+   * its segmentation map, so that neither is copied between the two stages.
+   */
   class LaBGen {
+    public:
+
+      typedef std::vector<cv::Mat>                                  MatsVec;
+
+    public:
+
+      static const size_t PIPELINE_DEPTH;
+
     protected:
 
       size_t height;
@@ -45,11 +62,20 @@ namespace ns_labgen {
       int32_t s;
       int32_t n;
       int32_t p;
+      bool incremental;
+      int32_t threads;
+      bool pipelined;
+      uint32_t seed;
       std::shared_ptr<IBGS> bgs;
       cv::Mat segmentation_map;
-      cv::Mat mat_for_bgs_lib;
-      ns_internals::PatchesHistory history;
+      std::unique_ptr<ns_internals::HistoryInterface> history;
+      cv::Mat cached_background;
       bool first_frame;
+      MatsVec frames_slots;
+      MatsVec segmentation_slots;
+      size_t current_slot;
+      /* Declared last to be joined before the slots and the history die. */
+      std::unique_ptr<ns_internals::Pipeline> pipeline;
 
     public:
 
@@ -59,12 +85,17 @@ namespace ns_labgen {
         std::string a,
         int32_t s,
         int32_t n,
-        int32_t p
+        int32_t p,
+        bool incremental = false,
+        int32_t threads = 1,
+        bool pipelined = false,
+        uint32_t seed = 0,
+        const BGSParams& bgs_params = BGSParams()
       );
 
       void insert(const cv::Mat& current_frame);
 
-      void generate_background(cv::Mat& background) const;
+      void generate_background(cv::Mat& background);
 
       size_t get_height() const;
 
@@ -78,6 +109,18 @@ namespace ns_labgen {
 
       int32_t get_p() const;
 
+      bool is_incremental() const;
+
+      int32_t get_threads() const;
+
+      bool is_pipelined() const;
+
+      uint32_t get_seed() const;
+
       const cv::Mat& get_segmentation_map() const;
+
+    protected:
+
+      void insert_pipelined(const cv::Mat& current_frame);
   };
 } /* ns_labgen */
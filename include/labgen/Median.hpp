@@ -0,0 +1,121 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ns_labgen {
+  namespace ns_internals {
+    /* ====================================================================== *
+     * Median                                                                 *
+     * ====================================================================== */
+
+    /*
+     * Median selection kernels working on buffers of 8-bit samples. For an
+     * even number of samples, the result is the truncated mean of the two
+     * middle values. The kernel is selected according to the number of
+     * samples: an insertion sort for small buffers, and a 256-bin counting
+     * selection for larger ones.
+     */
+    class Median {
+      public:
+
+        typedef unsigned char (*Kernel)(unsigned char* buffer, size_t size);
+
+      public:
+
+        static const size_t SORTING_THRESHOLD;
+
+      public:
+
+        static Kernel get_kernel(size_t size);
+
+        static unsigned char sorting(unsigned char* buffer, size_t size);
+
+        static unsigned char counting(unsigned char* buffer, size_t size);
+    };
+
+    /* ====================================================================== *
+     * MedianHistograms                                                       *
+     * ====================================================================== */
+
+    /*
+     * Per-sample 256-bin histograms maintained incrementally as buffers of
+     * 8-bit samples are added and removed, so that the median of every sample
+     * can be read without revisiting the buffers. Each histogram is split into
+     * 16 coarse bins and 256 fine bins, which bounds the search of a rank to 32
+     * steps. The results are identical to the ones of the Median kernels.
+     *
+     * The counters are 8-bit wide when at most 255 buffers are accounted at
+     * once, and 16-bit wide otherwise, so that the histograms take 272 bytes
+     * per sample (816 bytes per pixel, about 1.7 GB at 1080p) in the usual
+     * case, and twice as much for larger buffer sizes.
+     */
+    class MedianHistograms {
+      public:
+
+        typedef uint8_t                                          NarrowCounter;
+        typedef uint16_t                                           WideCounter;
+        typedef std::vector<NarrowCounter>                   NarrowCountersVec;
+        typedef std::vector<WideCounter>                       WideCountersVec;
+
+      public:
+
+        static const size_t MAX_COUNT;
+
+      protected:
+
+        size_t samples;
+        bool wide;
+        NarrowCountersVec narrow_coarse;
+        NarrowCountersVec narrow_fine;
+        WideCountersVec wide_coarse;
+        WideCountersVec wide_fine;
+
+      public:
+
+        explicit MedianHistograms(size_t max_count = MAX_COUNT);
+
+        void resize(size_t samples);
+
+        void add(const unsigned char* buffer, size_t size);
+
+        void remove(const unsigned char* buffer, size_t size);
+
+        void add(size_t sample, unsigned char value);
+
+        void remove(size_t sample, unsigned char value);
+
+        void median(
+          unsigned char* result,
+          size_t count,
+          size_t first,
+          size_t length
+        ) const;
+
+      protected:
+
+        unsigned char select(size_t sample, size_t rank) const;
+    };
+  } /* ns_internals */
+} /* ns_labgen */
@@ -0,0 +1,90 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns_labgen {
+  namespace ns_internals {
+    /* ====================================================================== *
+     * Pipeline                                                               *
+     * ====================================================================== */
+
+    /*
+     * Stage running on its own thread and consuming a bounded number of slots.
+     * The buffers of the slots belong to the caller: a slot is acquired by the
+     * producer, filled, then submitted to the stage, which gives it back once
+     * processed. A slot is thus never accessed by both sides at the same time
+     * and its buffers never need to be copied.
+     */
+    class Pipeline {
+      public:
+
+        typedef std::function<void(size_t)>                              Stage;
+
+      protected:
+
+        typedef std::vector<size_t>                                   SlotsVec;
+        typedef std::deque<size_t>                                  SlotsQueue;
+
+      protected:
+
+        Stage stage;
+        SlotsVec free_slots;
+        SlotsQueue queue;
+        bool busy;
+        bool stopping;
+        std::exception_ptr error;
+        mutable std::mutex mutex;
+        mutable std::condition_variable condition;
+        std::thread worker;
+
+      public:
+
+        Pipeline(size_t depth, const Stage& stage);
+
+        Pipeline(const Pipeline&) = delete;
+
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        ~Pipeline();
+
+        size_t acquire();
+
+        void release(size_t slot);
+
+        void submit(size_t slot);
+
+        void wait() const;
+
+      protected:
+
+        void work();
+    };
+  } /* ns_internals */
+} /* ns_labgen */
@@ -0,0 +1,95 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns_labgen {
+  namespace ns_internals {
+    /* ====================================================================== *
+     * ThreadPool                                                             *
+     * ====================================================================== */
+
+    /*
+     * Fixed set of workers running parallel loops over independent items.
+     * The items are split in one contiguous range per worker, and a worker
+     * which has exhausted its own range steals the remaining items of the
+     * others. The calling thread takes part in the loop as the first worker,
+     * so a pool of one thread runs everything serially without any thread.
+     */
+    class ThreadPool {
+      public:
+
+        typedef std::function<void(size_t)>                               Task;
+
+      protected:
+
+        struct Range {
+          std::atomic<size_t> next;
+          size_t end;
+        };
+
+        typedef std::vector<std::thread>                            WorkersVec;
+
+      protected:
+
+        size_t threads;
+        WorkersVec workers;
+        std::unique_ptr<Range[]> ranges;
+        std::mutex mutex;
+        std::condition_variable start_condition;
+        std::condition_variable done_condition;
+        const Task* task;
+        size_t generation;
+        size_t pending;
+        bool stopping;
+        std::exception_ptr error;
+
+      public:
+
+        explicit ThreadPool(size_t threads = 1);
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool();
+
+        size_t size() const;
+
+        void parallel_for(size_t count, const Task& task);
+
+      protected:
+
+        void work(size_t worker);
+
+        void run(size_t worker);
+    };
+  } /* ns_internals */
+} /* ns_labgen */
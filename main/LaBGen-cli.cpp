@@ -25,17 +25,23 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
-#include <vector>
 
 #include <boost/lexical_cast.hpp>
 
 #include <opencv2/core/core.hpp>
+#if defined(LABGEN_HEADLESS) && (OPENCV_VERSION != 2)
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+#else
 #include <opencv2/highgui/highgui.hpp>
+#endif
 
 #include <labgen/ArgumentsHandler.hpp>
+#include <labgen/FrameSource.hpp>
 #include <labgen/LaBGen.hpp>
+#ifndef LABGEN_HEADLESS
 #include <labgen/GridWindow.hpp>
 #include <labgen/TextProperties.hpp>
+#endif
 
 using namespace boost;
 using namespace cv;
@@ -76,40 +82,32 @@ int main(int argc, char** argv) {
   cout << endl;
 
   args_h.parse_vars_map();
+
+#ifdef LABGEN_HEADLESS
+  if (args_h.get_visualization() || args_h.get_record()) {
+    throw logic_error(
+      "Visualization and record are not available in a headless build!"
+    );
+  }
+#endif
+
   args_h.print_parameters();
 
   /****************************************************************************
    * Reading sequence.                                                        *
    ****************************************************************************/
 
-  VideoCapture decoder(args_h.get_input());
-
-  if (!decoder.isOpened()) {
-    throw runtime_error(
-      "Cannot open the '" + args_h.get_input() + "' sequence."
-    );
-  }
+  FrameSource frames(args_h.get_input());
 
-  int32_t height = decoder.get(CV_CAP_PROP_FRAME_HEIGHT);
-  int32_t width  = decoder.get(CV_CAP_PROP_FRAME_WIDTH);
+  int32_t height = frames.get_height();
+  int32_t width  = frames.get_width();
 
   cout << "Reading sequence " << args_h.get_input() << "..." << endl;
 
   cout << "           height: " << height     << endl;
-  cout << "            width: " << width      << endl;
-
-  typedef vector<Mat>                                                FramesVec;
-  vector<Mat> frames;
-  frames.reserve(decoder.get(CV_CAP_PROP_FRAME_COUNT));
-
-  Mat frame;
-
-  while (decoder.read(frame))
-    frames.push_back(frame.clone());
-
-  decoder.release();
-  cout << frames.size() << " frames read." << endl << endl;
+  cout << "            width: " << width      << endl << endl;
 
+#ifndef LABGEN_HEADLESS
   /****************************************************************************
    * Initialization of graphical components and video streams.                *
    ****************************************************************************/
@@ -159,6 +157,7 @@ int main(int argc, char** argv) {
       );
     }
   }
+#endif
 
   /****************************************************************************
    * Processing.                                                              *
@@ -169,6 +168,26 @@ int main(int argc, char** argv) {
   /* Initialization of the background matrix. */
   Mat background = Mat(height, width, CV_8UC3);
 
+  /*
+   * The bands of SuBSENSE, of the Zivkovic AGMM and of KDE are processed by
+   * as many threads as the patches. Without the pipeline, the background
+   * subtraction and the insertion into the history run one after the other,
+   * so both stages use all the threads. With the pipeline, they run
+   * concurrently, so the threads are split between them.
+   */
+  int32_t bgs_threads = args_h.get_threads();
+  int32_t history_threads = args_h.get_threads();
+
+  if (args_h.get_pipelined() && (args_h.get_threads() > 1)) {
+    history_threads = args_h.get_threads() / 2;
+    bgs_threads = args_h.get_threads() - history_threads;
+  }
+
+  BGSParams bgs_params;
+  bgs_params.subsense.nThreads = bgs_threads;
+  bgs_params.zivkovicAGMM.nThreads = bgs_threads;
+  bgs_params.kde.nThreads = bgs_threads;
+
   /* Initialization of the LaBGen algorithm. */
   LaBGen labgen(
     height,
@@ -176,16 +195,20 @@ int main(int argc, char** argv) {
     args_h.get_a_param(),
     args_h.get_s_param(),
     args_h.get_n_param(),
-    args_h.get_p_param()
+    args_h.get_p_param(),
+    args_h.get_incremental(),
+    history_threads,
+    args_h.get_pipelined(),
+    args_h.get_seed(),
+    bgs_params
   );
 
   /* Processing loop. */
   cout << endl << "Processing..." << endl;
   bool first_frame = true;
 
-  FramesVec::const_iterator begin = frames.begin();
-  FramesVec::const_iterator it    = begin;
-  FramesVec::const_iterator end   = frames.end();
+  Mat frame;
+  size_t index = 0;
 
   for (
     int32_t pass = 0, passes = (args_h.get_p_param() + 1) / 2;
@@ -198,29 +221,45 @@ int main(int argc, char** argv) {
     bool forward = true;
 
     do {
-      labgen.insert(*it);
+      /* If the end of the sequence is reached. */
+      if (!frames.read(index, frame)) {
+        /* Kitchen with the index. */
+        if ((pass == (passes - 1)) || (index < 2))
+          break;
+
+        index -= 2;
+        forward = false;
+
+        cout << endl << "Processing pass number ";
+        cout << lexical_cast<string>((pass + 1) * 2) << "..." << endl;
+
+        continue;
+      }
+
+      labgen.insert(frame);
 
       /* Skipping first frame. */
       if (first_frame) {
         cout << "Skipping first frame..." << endl;
 
-        ++it;
+        ++index;
         first_frame = false;
 
         continue;
       }
 
+#ifndef LABGEN_HEADLESS
       /* Visualization. */
       if (args_h.get_visualization() || args_h.get_record()) {
         labgen.generate_background(background);
 
         if (args_h.get_split_vis()) {
-          imshow("Input video", *it);
+          imshow("Input video", frame);
           imshow("Segmentation map", labgen.get_segmentation_map());
           imshow("LaBGen", background);
         }
         else {
-          window->display(*it, 0);
+          window->display(frame, 0);
           window->put_title("Input video", 0);
 
           window->display(labgen.get_segmentation_map(), 1);
@@ -239,25 +278,15 @@ int main(int argc, char** argv) {
         if (args_h.get_visualization())
           waitKey(args_h.get_wait());
       }
+#endif
 
-      /* Move iterator. */
-      it = (forward) ? ++it : --it;
-
-      /* If iterator is at the end. */
-      if (it == end) {
-        /* Kitchen with the iterator. */
-        if (pass == (passes - 1))
-          break;
-
-        it -= 2;
-        forward = false;
-
-        cout << endl << "Processing pass number ";
-        cout << lexical_cast<string>((pass + 1) * 2) << "..." << endl;
-      }
-    } while (it != begin);
+      /* Move index. */
+      index = (forward) ? (index + 1) : (index - 1);
+    } while (index != 0);
   }
 
+  cout << endl << frames.size() << " frames read." << endl << endl;
+
   /* Compute background and write it. */
   stringstream output_file;
 
@@ -272,6 +301,7 @@ int main(int argc, char** argv) {
   cout << "Writing " << output_file.str() << "..." << endl;
   imwrite(output_file.str(), background);
 
+#ifndef LABGEN_HEADLESS
   /* Cleaning. */
   if (args_h.get_visualization()) {
     cout << endl << "Press any key in a graphical window to quit..." << endl;
@@ -281,6 +311,7 @@ int main(int argc, char** argv) {
     if (args_h.get_record())
       record_stream->release();
   }
+#endif
 
   /* Bye. */
   return EXIT_SUCCESS;
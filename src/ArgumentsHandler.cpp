@@ -70,6 +70,10 @@ void ArgumentsHandler::parse_vars_map() {
   parse_s_param();
   parse_n_param();
   parse_p_param();
+  parse_incremental();
+  parse_threads();
+  parse_pipelined();
+  parse_seed();
   parse_visualization();
   parse_split_vis();
   parse_record();
@@ -117,6 +121,30 @@ int32_t ArgumentsHandler::get_p_param() const {
 
 /******************************************************************************/
 
+bool ArgumentsHandler::get_incremental() const {
+  return incremental;
+}
+
+/******************************************************************************/
+
+int32_t ArgumentsHandler::get_threads() const {
+  return threads;
+}
+
+/******************************************************************************/
+
+bool ArgumentsHandler::get_pipelined() const {
+  return pipelined;
+}
+
+/******************************************************************************/
+
+uint32_t ArgumentsHandler::get_seed() const {
+  return seed;
+}
+
+/******************************************************************************/
+
 bool ArgumentsHandler::get_visualization() const {
   return visualization;
 }
@@ -181,6 +209,10 @@ void ArgumentsHandler::print_parameters(ostream& os) const {
   else
   os << "                N: pixel" << endl;
   os << "                P: "      << p_param       << endl;
+  os << "      Incremental: "      << incremental   << endl;
+  os << "          Threads: "      << threads       << endl;
+  os << "        Pipelined: "      << pipelined     << endl;
+  os << "             Seed: "      << seed          << endl;
   os << "    Visualization: "      << visualization << endl;
   if (visualization)
   os << "        Split vis: "      << split_vis     << endl;
@@ -246,6 +278,29 @@ void ArgumentsHandler::define_options() {
       "default,d",
       "use the default set of parameters"
     )
+    (
+      "incremental,c",
+      "maintain the median of the history incrementally (faster when the "
+      "background is generated often, at the cost of memory)"
+    )
+    (
+      "threads,j",
+      value<int32_t>()->default_value(1),
+      "number of threads used to process the patches (and the bands of the "
+      "frames with SuBSENSE, the Zivkovic AGMM and KDE), split between the "
+      "two stages when pipelined"
+    )
+    (
+      "pipelined,e",
+      "insert the frames into the history in a separate thread, concurrently "
+      "with the background subtraction of the next frames"
+    )
+    (
+      "seed",
+      value<uint32_t>()->default_value(0),
+      "seed of the random generators of the background subtraction "
+      "(SuBSENSE), for runs reproducible whatever the number of threads"
+    )
     (
       "visualization,v",
       "enable visualization"
@@ -398,6 +453,33 @@ void ArgumentsHandler::parse_p_param() {
 
 /******************************************************************************/
 
+void ArgumentsHandler::parse_incremental() {
+  incremental = vars_map.count("incremental");
+}
+
+/******************************************************************************/
+
+void ArgumentsHandler::parse_threads() {
+  threads = vars_map["threads"].as<int32_t>();
+
+  if (threads < 1)
+    throw logic_error("The number of threads must be positive!");
+}
+
+/******************************************************************************/
+
+void ArgumentsHandler::parse_pipelined() {
+  pipelined = vars_map.count("pipelined");
+}
+
+/******************************************************************************/
+
+void ArgumentsHandler::parse_seed() {
+  seed = vars_map["seed"].as<uint32_t>();
+}
+
+/******************************************************************************/
+
 void ArgumentsHandler::parse_visualization() {
   visualization = vars_map.count("visualization");
 }
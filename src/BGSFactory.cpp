@@ -40,27 +40,36 @@ using namespace ns_labgen::ns_internals;
  * BGSFactory                                                                 *
  * ========================================================================== */
 
-shared_ptr<IBGS> BGSFactory::get_bgs_algorithm(string algorithm) {
+shared_ptr<IBGS> BGSFactory::get_bgs_algorithm(
+  string algorithm,
+  const BGSParams& params
+) {
   if (algorithm == "frame_difference")
-    return shared_ptr<IBGS>(new FrameDifferenceBGS);
+    return shared_ptr<IBGS>(new FrameDifferenceBGS(params.frameDifference));
   else if (algorithm == "mog_grimson")
-    return shared_ptr<IBGS>(new DPGrimsonGMMBGS);
+    return shared_ptr<IBGS>(new DPGrimsonGMMBGS(params.grimsonGMM));
   else if (algorithm == "mog_zivkovic")
-    return shared_ptr<IBGS>(new DPZivkovicAGMMBGS);
+    return shared_ptr<IBGS>(new DPZivkovicAGMMBGS(params.zivkovicAGMM));
   else if (algorithm == "pfinder")
-    return shared_ptr<IBGS>(new DPWrenGABGS);
+    return shared_ptr<IBGS>(new DPWrenGABGS(params.wrenGA));
+  else if (algorithm == "pfinder_fixed") {
+    DPWrenGAParams wrenGA = params.wrenGA;
+    wrenGA.fixedPoint = true;
+
+    return shared_ptr<IBGS>(new DPWrenGABGS(wrenGA));
+  }
   else if (algorithm == "lbp")
-    return shared_ptr<IBGS>(new DPTextureBGS);
+    return shared_ptr<IBGS>(new DPTextureBGS(params.texture));
   else if (algorithm == "som_adaptive")
-    return shared_ptr<IBGS>(new LBAdaptiveSOM);
+    return shared_ptr<IBGS>(new LBAdaptiveSOM(params.adaptiveSOM));
   else if (algorithm == "vumeter")
-    return shared_ptr<IBGS>(new VuMeter);
+    return shared_ptr<IBGS>(new VuMeter(params.vuMeter));
   else if (algorithm == "kde")
-    return shared_ptr<IBGS>(new KDE);
+    return shared_ptr<IBGS>(new KDE(params.kde));
   else if (algorithm == "sigma_delta")
-    return shared_ptr<IBGS>(new SigmaDeltaBGS);
+    return shared_ptr<IBGS>(new SigmaDeltaBGS(params.sigmaDelta));
   else if (algorithm == "subsense")
-    return shared_ptr<IBGS>(new SuBSENSEBGS);
+    return shared_ptr<IBGS>(new SuBSENSEBGS(params.subsense));
   else {
     throw runtime_error(
       "The BGS algorithm " + algorithm + " is not supported."
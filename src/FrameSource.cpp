@@ -0,0 +1,193 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+
+#include <boost/lexical_cast.hpp>
+
+#include <labgen/FrameSource.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace cv;
+using namespace ns_labgen;
+
+/* ========================================================================== *
+ * FrameSource                                                                *
+ * ========================================================================== */
+
+const size_t FrameSource::DEFAULT_CACHE_SIZE = 64;
+
+/******************************************************************************/
+
+FrameSource::FrameSource(const string& input, size_t cache_size) :
+input(input),
+decoder(),
+height(0),
+width(0),
+position(0),
+frames_count(0),
+frames_count_known(false),
+cache(),
+cache_begin(0),
+cache_end(0) {
+  if (cache_size == 0)
+    throw logic_error("The size of the frames cache must be larger than 0");
+
+  cache.resize(cache_size);
+  open();
+
+  height = decoder.get(CV_CAP_PROP_FRAME_HEIGHT);
+  width  = decoder.get(CV_CAP_PROP_FRAME_WIDTH);
+}
+
+/******************************************************************************/
+
+bool FrameSource::read(size_t index, Mat& frame) {
+  if (frames_count_known && (index >= frames_count))
+    return false;
+
+  /* The frame is still in the cache. */
+  if ((index >= cache_begin) && (index < cache_end)) {
+    cache[index - cache_begin].copyTo(frame);
+    return true;
+  }
+
+  /* Going backward: decode the chunk of frames ending at the index. */
+  if (index < position) {
+    fill_cache(index);
+    cache[index - cache_begin].copyTo(frame);
+
+    return true;
+  }
+
+  /* Going forward: decode the next frame. */
+  seek(index);
+
+  if (!decoder.read(frame)) {
+    frames_count = position;
+    frames_count_known = true;
+
+    return false;
+  }
+
+  ++position;
+  return true;
+}
+
+/******************************************************************************/
+
+int32_t FrameSource::get_height() const {
+  return height;
+}
+
+/******************************************************************************/
+
+int32_t FrameSource::get_width() const {
+  return width;
+}
+
+/******************************************************************************/
+
+bool FrameSource::is_size_known() const {
+  return frames_count_known;
+}
+
+/******************************************************************************/
+
+size_t FrameSource::size() const {
+  return frames_count_known ? frames_count : position;
+}
+
+/******************************************************************************/
+
+void FrameSource::open() {
+  decoder.release();
+
+  if (!decoder.open(input))
+    throw runtime_error("Cannot open the '" + input + "' sequence.");
+
+  position = 0;
+}
+
+/******************************************************************************/
+
+void FrameSource::seek(size_t index) {
+  if (index == position)
+    return;
+
+  /*
+   * Try to seek directly, and fall back to decoding from the beginning of the
+   * sequence if the backend cannot reach the exact frame.
+   */
+  if (
+    (index != 0) &&
+    decoder.set(CV_CAP_PROP_POS_FRAMES, index) &&
+    (static_cast<size_t>(decoder.get(CV_CAP_PROP_POS_FRAMES)) == index)
+  ) {
+    position = index;
+    return;
+  }
+
+  open();
+
+  while (position < index) {
+    if (!decoder.grab()) {
+      throw runtime_error(
+        "Cannot reach the frame " + lexical_cast<string>(index) + " of the '" +
+        input + "' sequence."
+      );
+    }
+
+    ++position;
+  }
+}
+
+/******************************************************************************/
+
+void FrameSource::fill_cache(size_t index) {
+  size_t begin = (index + 1 > cache.size()) ? (index + 1 - cache.size()) : 0;
+  size_t end = index + 1;
+
+  /* Invalidate the cache while it is being refilled. */
+  cache_begin = cache_end = 0;
+  seek(begin);
+
+  /*
+   * Up to OpenCV 2, the decoded frame may be a header over the internal buffer
+   * of the decoder, hence the explicit copy into each slot of the cache.
+   */
+  Mat decoded;
+
+  for (size_t i = begin; i < end; ++i) {
+    if (!decoder.read(decoded)) {
+      throw runtime_error(
+        "Cannot decode the frame " + lexical_cast<string>(i) + " of the '" +
+        input + "' sequence."
+      );
+    }
+
+    decoded.copyTo(cache[i - begin]);
+    ++position;
+  }
+
+  cache_begin = begin;
+  cache_end = end;
+}
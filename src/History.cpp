@@ -19,54 +19,73 @@
  * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 #include <labgen/History.hpp>
+#include <labgen/Median.hpp>
 
 using namespace std;
 using namespace cv;
 using namespace ns_labgen::ns_internals;
 
 /* ========================================================================== *
- * HistoryMat                                                                 *
+ * HistoryEntry                                                               *
  * ========================================================================== */
 
-HistoryMat::HistoryMat(const Mat& mat, const uint32_t positives) :
-mat(mat.clone()), positives(positives) {}
+HistoryEntry::HistoryEntry(size_t slot, const uint32_t positives) :
+slot(slot), positives(positives) {}
 
 /******************************************************************************/
 
-HistoryMat::HistoryMat(const HistoryMat& copy) :
-mat(copy.mat.clone()), positives(copy.positives) {}
-
-/******************************************************************************/
-
-HistoryMat& HistoryMat::operator=(const HistoryMat& copy) {
-  if (this != &copy) {
-    copy.mat.copyTo(mat);
-    positives = copy.positives;
-  }
-
-  return *this;
+size_t HistoryEntry::get_slot() const {
+  return slot;
 }
 
 /******************************************************************************/
 
-Mat& HistoryMat::operator*() {
-  return mat;
-}
-
-/******************************************************************************/
-
-const Mat& HistoryMat::operator*() const {
-  return mat;
+uint32_t HistoryEntry::get_positives() const {
+  return positives;
 }
 
 /* ========================================================================== *
  * History                                                                    *
  * ========================================================================== */
 
-History::History(size_t buffer_size) : history(), buffer_size(buffer_size) {
-  history.reserve(buffer_size + 1);
+History::History(
+  size_t buffer_size,
+  const Size& patch_size,
+  bool incremental
+) :
+history(),
+buffer_size(buffer_size),
+slab(buffer_size * patch_size.height, patch_size.width, CV_8UC3),
+slots(),
+free_slots(),
+incremental(incremental),
+histograms(buffer_size),
+buffer_r(buffer_size),
+buffer_g(buffer_size),
+buffer_b(buffer_size),
+dirty(true),
+refreshed_size(0) {
+  if (incremental && (buffer_size > MedianHistograms::MAX_COUNT)) {
+    throw logic_error(
+      "The incremental median does not support such a large buffer size"
+    );
+  }
+
+  history.reserve(buffer_size);
+  slots.reserve(buffer_size);
+  free_slots.reserve(buffer_size);
+
+  for (size_t i = 0; i < buffer_size; ++i) {
+    slots.push_back(
+      slab.rowRange(i * patch_size.height, (i + 1) * patch_size.height)
+    );
+
+    free_slots.push_back(buffer_size - i - 1);
+  }
 }
 
 /******************************************************************************/
@@ -83,136 +102,456 @@ const History::HistoryVec& History::operator*() const {
 
 /******************************************************************************/
 
+const Mat& History::get_patch(size_t rank) const {
+  return slots[history[rank].get_slot()];
+}
+
+/******************************************************************************/
+
 void History::insert(const Mat& segmentation_map, const Mat& current_frame) {
-  uint32_t positives = countNonZero(segmentation_map);
-
-  if (history.empty())
-    history.push_back(HistoryMat(current_frame, positives));
-  else {
-    bool inserted = false;
-
-    for (
-      HistoryVec::iterator it = history.begin(), end = history.end();
-      it != end;
-      ++it
-    ) {
-      if (positives <= (*it)) {
-        history.insert(it, HistoryMat(current_frame, positives));
-        inserted = true;
-
-        if (history.size() > buffer_size)
-          history.erase(history.end() - 1);
-
-        break;
-      }
-    }
+  insert(countNonZero(segmentation_map), current_frame);
+}
+
+/******************************************************************************/
+
+void History::insert(uint32_t positives, const Mat& current_frame) {
+  /* The new patch goes before the first one having as many positives. */
+  size_t rank =
+    lower_bound(history.begin(), history.end(), positives) - history.begin();
+
+  if (history.size() == buffer_size) {
+    if (rank == history.size())
+      return;
 
-    if ((history.size() < buffer_size) && !inserted)
-      history.push_back(HistoryMat(current_frame, positives));
+    /* Recycle the slot of the worst patch. */
+    size_t evicted = history.back().get_slot();
+
+    if (incremental)
+      account(slots[evicted], false);
+
+    history.pop_back();
+    free_slots.push_back(evicted);
   }
+
+  size_t slot = free_slots.back();
+  free_slots.pop_back();
+
+  current_frame.copyTo(slots[slot]);
+  history.insert(history.begin() + rank, HistoryEntry(slot, positives));
+  dirty = true;
+
+  if (incremental)
+    account(slots[slot], true);
 }
 
 /******************************************************************************/
 
-void History::median(Mat& result, size_t size) const {
-  if (history.size() == 1 || size == 1)
-    (*(history[0])).copyTo(result);
+void History::median(Mat& result, size_t size) {
+  if (history.size() == 1 || size == 1) {
+    get_patch(0).copyTo(result);
+    return;
+  }
 
-  static vector<unsigned char> buffer_r(buffer_size);
-  static vector<unsigned char> buffer_g(buffer_size);
-  static vector<unsigned char> buffer_b(buffer_size);
+  size_t row_length = result.cols * 3;
+
+  /* The histograms describe the whole history. */
+  if (incremental && (size >= history.size())) {
+    for (int32_t row = 0; row < result.rows; ++row) {
+      histograms.median(
+        result.ptr(row),
+        history.size(),
+        row * row_length,
+        row_length
+      );
+    }
 
-  size_t _size = min(history.size(), size);
+    return;
+  }
 
-  for (size_t i = 0; i < ((*(history[0])).total() * 3); i += 3) {
-    for (size_t num = 0; num < _size; ++num) {
-      buffer_r[num] = (*(history[num])).data[i    ];
-      buffer_g[num] = (*(history[num])).data[i + 1];
-      buffer_b[num] = (*(history[num])).data[i + 2];
-    }
+  size_t _size = min(history.size(), size);
+  size_t slot_length = slots[0].total() * 3;
+  Median::Kernel kernel = Median::get_kernel(_size);
 
-    sort(buffer_r.begin(), buffer_r.begin() + _size);
-    sort(buffer_g.begin(), buffer_g.begin() + _size);
-    sort(buffer_b.begin(), buffer_b.begin() + _size);
+  for (int32_t row = 0; row < result.rows; ++row) {
+    unsigned char* result_row = result.ptr(row);
+    size_t offset = row * row_length;
 
-    size_t middle = _size / 2;
+    for (size_t i = 0; i < row_length; i += 3) {
+      for (size_t num = 0; num < _size; ++num) {
+        const unsigned char* sample =
+          slab.data + (history[num].get_slot() * slot_length) + offset + i;
 
-    if (_size & 1) {
-      nth_element(buffer_r.begin(), buffer_r.begin() + middle, buffer_r.begin() + _size);
-      nth_element(buffer_g.begin(), buffer_g.begin() + middle, buffer_g.begin() + _size);
-      nth_element(buffer_b.begin(), buffer_b.begin() + middle, buffer_b.begin() + _size);
+        buffer_r[num] = sample[0];
+        buffer_g[num] = sample[1];
+        buffer_b[num] = sample[2];
+      }
 
-      result.data[i    ] = buffer_r[middle];
-      result.data[i + 1] = buffer_g[middle];
-      result.data[i + 2] = buffer_b[middle];
-    }
-    else {
-      nth_element(buffer_r.begin(), buffer_r.begin() + (middle - 1), buffer_r.begin() + _size);
-      nth_element(buffer_g.begin(), buffer_g.begin() + (middle - 1), buffer_g.begin() + _size);
-      nth_element(buffer_b.begin(), buffer_b.begin() + (middle - 1), buffer_b.begin() + _size);
-
-      nth_element(buffer_r.begin() + middle, buffer_r.begin() + middle, buffer_r.begin() + _size);
-      nth_element(buffer_g.begin() + middle, buffer_g.begin() + middle, buffer_g.begin() + _size);
-      nth_element(buffer_b.begin() + middle, buffer_b.begin() + middle, buffer_b.begin() + _size);
-
-      result.data[i    ] = ((static_cast<int32_t>(buffer_r[middle - 1])) + (buffer_r[middle])) / 2;
-      result.data[i + 1] = ((static_cast<int32_t>(buffer_g[middle - 1])) + (buffer_g[middle])) / 2;
-      result.data[i + 2] = ((static_cast<int32_t>(buffer_b[middle - 1])) + (buffer_b[middle])) / 2;
+      result_row[i    ] = kernel(buffer_r.data(), _size);
+      result_row[i + 1] = kernel(buffer_g.data(), _size);
+      result_row[i + 2] = kernel(buffer_b.data(), _size);
     }
   }
 }
 
 /******************************************************************************/
 
+void History::refresh(Mat& result, size_t size) {
+  if (!dirty && (size == refreshed_size))
+    return;
+
+  median(result, size);
+
+  dirty = false;
+  refreshed_size = size;
+}
+
+/******************************************************************************/
+
 bool History::empty() const {
   return history.empty();
 }
 
+/******************************************************************************/
+
+bool History::is_incremental() const {
+  return incremental;
+}
+
+/******************************************************************************/
+
+void History::account(const Mat& patch, bool added) {
+  if (added)
+    histograms.add(patch.data, patch.total() * 3);
+  else
+    histograms.remove(patch.data, patch.total() * 3);
+}
+
 /* ========================================================================== *
  * PatchesHistory                                                             *
  * ========================================================================== */
 
-PatchesHistory::PatchesHistory(const Utils::ROIs& rois, size_t buffer_size) :
-p_history(), rois(rois) {
+PatchesHistory::PatchesHistory(
+  const Utils::ROIs& rois,
+  size_t buffer_size,
+  bool incremental,
+  size_t threads
+) :
+p_history(),
+rois(rois),
+pool(threads),
+integral_height(0),
+integral_width(0),
+integral() {
   p_history.reserve(rois.size());
 
-  for (size_t i = 0; i < rois.size(); ++i)
-    p_history.push_back(History(buffer_size));
+  for (size_t i = 0; i < rois.size(); ++i) {
+    p_history.emplace_back(buffer_size, rois[i].size(), incremental);
+
+    integral_height = max(integral_height, size_t(rois[i].y + rois[i].height));
+    integral_width  = max(integral_width,  size_t(rois[i].x + rois[i].width));
+  }
+
+  /* The first row and column of the table stay null. */
+  integral.assign((integral_height + 1) * (integral_width + 1), 0);
 }
 
 /****************************************************************************/
 
 void PatchesHistory::insert(const Mat& segmentation_map, const Mat& current_frame) {
-  for (size_t i = 0; i < rois.size(); ++i) {
-    p_history[i].insert(
-      segmentation_map(rois[i]),
-      current_frame(rois[i])
-    );
-  }
+  count_positives(segmentation_map);
+
+  pool.parallel_for(
+    rois.size(),
+    [this, &current_frame](size_t i) {
+      p_history[i].insert(get_positives(rois[i]), current_frame(rois[i]));
+    }
+  );
 }
 
 /****************************************************************************/
 
-void PatchesHistory::median(Mat& result, size_t size) const {
-  for (size_t i = 0; i < rois.size(); ++i) {
-    Mat patch(
-      (*((*(p_history[i])).back())).rows,
-      (*((*(p_history[i])).back())).cols,
-      CV_8UC3
-    );
+void PatchesHistory::median(Mat& result, size_t size) {
+  pool.parallel_for(
+    rois.size(),
+    [this, &result, size](size_t i) {
+      Mat patch = result(rois[i]);
+      p_history[i].median(patch, size);
+    }
+  );
+}
 
-    p_history[i].median(patch, size);
-    patch.copyTo(result(rois[i]));
-  }
+/******************************************************************************/
+
+void PatchesHistory::refresh(Mat& result, size_t size) {
+  pool.parallel_for(
+    rois.size(),
+    [this, &result, size](size_t i) {
+      Mat patch = result(rois[i]);
+      p_history[i].refresh(patch, size);
+    }
+  );
 }
 
 /******************************************************************************/
 
 bool PatchesHistory::empty() const {
- for (History h : p_history) {
+ for (const History& h : p_history) {
    if (h.empty())
      return true;
  }
 
  return false;
 }
+
+/******************************************************************************/
+
+void PatchesHistory::count_positives(const Mat& segmentation_map) {
+  size_t stride = integral_width + 1;
+
+  for (size_t row = 0; row < integral_height; ++row) {
+    const unsigned char* seg_row = segmentation_map.ptr(row);
+    const uint32_t* above = integral.data() + (row * stride) + 1;
+    uint32_t* current = integral.data() + ((row + 1) * stride) + 1;
+    uint32_t row_sum = 0;
+
+    for (size_t col = 0; col < integral_width; ++col) {
+      row_sum += (seg_row[col] != 0);
+      current[col] = above[col] + row_sum;
+    }
+  }
+}
+
+/******************************************************************************/
+
+uint32_t PatchesHistory::get_positives(const Rect& roi) const {
+  size_t stride = integral_width + 1;
+  size_t top = roi.y * stride;
+  size_t bottom = (roi.y + roi.height) * stride;
+  size_t left = roi.x;
+  size_t right = roi.x + roi.width;
+
+  return integral[bottom + right] - integral[bottom + left] -
+         integral[top + right] + integral[top + left];
+}
+
+/* ========================================================================== *
+ * PixelsHistory                                                              *
+ * ========================================================================== */
+
+const uint32_t PixelsHistory::POSITIVE_FLAG = 0x80000000;
+
+/******************************************************************************/
+
+const uint32_t PixelsHistory::MAX_STAMP = 0x7FFFFFFF;
+
+/******************************************************************************/
+
+PixelsHistory::PixelsHistory(
+  size_t height,
+  size_t width,
+  size_t buffer_size,
+  bool incremental
+) :
+height(height),
+width(width),
+pixels(height * width),
+buffer_size(buffer_size),
+count(0),
+stamp(0),
+samples(buffer_size * height * width * 3),
+priorities(buffer_size * height * width),
+worst_priorities(height * width),
+worst_slots(height * width),
+incremental(incremental),
+histograms(buffer_size),
+buffer_r(buffer_size),
+buffer_g(buffer_size),
+buffer_b(buffer_size),
+ranking(buffer_size) {
+  if (incremental) {
+    if (buffer_size > MedianHistograms::MAX_COUNT) {
+      throw logic_error(
+        "The incremental median does not support such a large buffer size"
+      );
+    }
+
+    histograms.resize(pixels * 3);
+  }
+}
+
+/******************************************************************************/
+
+void PixelsHistory::insert(
+  const Mat& segmentation_map,
+  const Mat& current_frame
+) {
+  /* Older samples get higher priorities, i.e. are evicted first. */
+  uint32_t age = MAX_STAMP - (stamp++ & MAX_STAMP);
+  size_t row_length = width * 3;
+
+  /* As long as the history is not full, every sample is inserted. */
+  if (count < buffer_size) {
+    unsigned char* samples_plane = samples.data() + (count * pixels * 3);
+    uint32_t* priorities_plane = priorities.data() + (count * pixels);
+
+    for (size_t row = 0; row < height; ++row) {
+      const unsigned char* seg_row = segmentation_map.ptr(row);
+      const unsigned char* frame_row = current_frame.ptr(row);
+
+      memcpy(samples_plane + (row * row_length), frame_row, row_length);
+
+      for (size_t col = 0; col < width; ++col) {
+        priorities_plane[(row * width) + col] =
+          ((seg_row[col] != 0) ? POSITIVE_FLAG : 0) | age;
+      }
+
+      if (incremental) {
+        for (size_t i = 0; i < row_length; ++i)
+          histograms.add((row * row_length) + i, frame_row[i]);
+      }
+    }
+
+    ++count;
+    return;
+  }
+
+  find_worst_slots();
+
+  for (size_t row = 0; row < height; ++row) {
+    const unsigned char* seg_row = segmentation_map.ptr(row);
+    const unsigned char* frame_row = current_frame.ptr(row);
+
+    for (size_t col = 0; col < width; ++col) {
+      size_t pixel = (row * width) + col;
+      bool positive = (seg_row[col] != 0);
+
+      /* A positive sample can only replace another positive sample. */
+      if (positive && !(worst_priorities[pixel] & POSITIVE_FLAG))
+        continue;
+
+      size_t slot = worst_slots[pixel];
+      unsigned char* sample = samples.data() + (((slot * pixels) + pixel) * 3);
+      const unsigned char* value = frame_row + (col * 3);
+
+      if (incremental) {
+        for (size_t channel = 0; channel < 3; ++channel) {
+          histograms.remove((pixel * 3) + channel, sample[channel]);
+          histograms.add((pixel * 3) + channel, value[channel]);
+        }
+      }
+
+      sample[0] = value[0];
+      sample[1] = value[1];
+      sample[2] = value[2];
+
+      priorities[(slot * pixels) + pixel] =
+        (positive ? POSITIVE_FLAG : 0) | age;
+    }
+  }
+}
+
+/******************************************************************************/
+
+void PixelsHistory::median(Mat& result, size_t size) {
+  size_t _size = min(count, size);
+  size_t row_length = width * 3;
+
+  /* The histograms describe the whole history. */
+  if (incremental && (size >= count)) {
+    for (size_t row = 0; row < height; ++row) {
+      histograms.median(
+        result.ptr(row),
+        count,
+        row * row_length,
+        row_length
+      );
+    }
+
+    return;
+  }
+
+  Median::Kernel kernel = Median::get_kernel(_size);
+
+  for (size_t row = 0; row < height; ++row) {
+    unsigned char* result_row = result.ptr(row);
+
+    for (size_t col = 0; col < width; ++col) {
+      size_t pixel = (row * width) + col;
+
+      /* Only the samples of lowest priorities are considered. */
+      if (_size < count)
+        rank_slots(pixel, _size);
+
+      for (size_t num = 0; num < _size; ++num) {
+        size_t slot = (_size < count) ? ranking[num] : num;
+        const unsigned char* sample =
+          samples.data() + (((slot * pixels) + pixel) * 3);
+
+        buffer_r[num] = sample[0];
+        buffer_g[num] = sample[1];
+        buffer_b[num] = sample[2];
+      }
+
+      result_row[(col * 3)    ] = kernel(buffer_r.data(), _size);
+      result_row[(col * 3) + 1] = kernel(buffer_g.data(), _size);
+      result_row[(col * 3) + 2] = kernel(buffer_b.data(), _size);
+    }
+  }
+}
+
+/******************************************************************************/
+
+void PixelsHistory::refresh(Mat& result, size_t size) {
+  /* Every insertion reaches most of the pixels: nothing is worth tracking. */
+  median(result, size);
+}
+
+/******************************************************************************/
+
+bool PixelsHistory::empty() const {
+  return count == 0;
+}
+
+/******************************************************************************/
+
+void PixelsHistory::find_worst_slots() {
+  copy(
+    priorities.begin(),
+    priorities.begin() + pixels,
+    worst_priorities.begin()
+  );
+
+  fill(worst_slots.begin(), worst_slots.end(), 0);
+
+  /* Plane by plane, so that the loop runs over contiguous pixels. */
+  for (size_t slot = 1; slot < buffer_size; ++slot) {
+    const uint32_t* priorities_plane = priorities.data() + (slot * pixels);
+
+    for (size_t pixel = 0; pixel < pixels; ++pixel) {
+      bool worse = priorities_plane[pixel] > worst_priorities[pixel];
+
+      worst_priorities[pixel] =
+        worse ? priorities_plane[pixel] : worst_priorities[pixel];
+      worst_slots[pixel] = worse ? slot : worst_slots[pixel];
+    }
+  }
+}
+
+/******************************************************************************/
+
+void PixelsHistory::rank_slots(size_t pixel, size_t size) {
+  const uint32_t* pixel_priorities = priorities.data() + pixel;
+  size_t stride = pixels;
+
+  for (size_t slot = 0; slot < count; ++slot)
+    ranking[slot] = slot;
+
+  nth_element(
+    ranking.begin(),
+    ranking.begin() + size,
+    ranking.begin() + count,
+    [pixel_priorities, stride](uint32_t lhs, uint32_t rhs) {
+      return pixel_priorities[lhs * stride] < pixel_priorities[rhs * stride];
+    }
+  );
+}
@@ -21,8 +21,6 @@
 #include <algorithm>
 #include <stdexcept>
 
-#include <opencv2/imgproc/imgproc.hpp>
-
 #include <labgen/BGSFactory.hpp>
 #include <labgen/LaBGen.hpp>
 #include <labgen/Utils.hpp>
@@ -36,13 +34,22 @@ using namespace ns_labgen::ns_internals;
  * LaBGen                                                                     *
  * ========================================================================== */
 
+const size_t LaBGen::PIPELINE_DEPTH = 3;
+
+/******************************************************************************/
+
 LaBGen::LaBGen(
   size_t height,
   size_t width,
   string a,
   int32_t s,
   int32_t n,
-  int32_t p
+  int32_t p,
+  bool incremental,
+  int32_t threads,
+  bool pipelined,
+  uint32_t seed,
+  const BGSParams& bgs_params
 ) :
 height(height),
 width(width),
@@ -50,17 +57,70 @@ a(a),
 s(s),
 n(n),
 p(p),
-bgs(BGSFactory::get_bgs_algorithm(a)),
+incremental(incremental),
+threads(threads),
+pipelined(pipelined),
+seed(seed),
+bgs(),
 segmentation_map(Mat(height, width, CV_8UC1)),
-mat_for_bgs_lib(Mat(height, width, CV_8UC3)),
-history(Utils::getROIs(height, width, n), s),
-first_frame(true) {}
+history(),
+cached_background(Mat(height, width, CV_8UC3)),
+first_frame(true),
+frames_slots(),
+segmentation_slots(),
+current_slot(0),
+pipeline() {
+  /* The seed overrides the one of the parameters of the random generators. */
+  BGSParams seeded_params = bgs_params;
+  seeded_params.subsense.nSeed = seed;
+
+  bgs = BGSFactory::get_bgs_algorithm(a, seeded_params);
+
+  /* The pixel-level history does not need one ROI per pixel. */
+  if (n == 0) {
+    history = unique_ptr<HistoryInterface>(
+      new PixelsHistory(height, width, s, incremental)
+    );
+  }
+  else {
+    history = unique_ptr<HistoryInterface>(
+      new PatchesHistory(
+        Utils::getROIs(height, width, n),
+        s,
+        incremental,
+        threads
+      )
+    );
+  }
+
+  if (pipelined) {
+    for (size_t i = 0; i < PIPELINE_DEPTH; ++i) {
+      frames_slots.push_back(Mat(height, width, CV_8UC3));
+      segmentation_slots.push_back(Mat(height, width, CV_8UC1));
+    }
+
+    pipeline = unique_ptr<Pipeline>(
+      new Pipeline(PIPELINE_DEPTH, [this](size_t slot) {
+        history->insert(segmentation_slots[slot], frames_slots[slot]);
+      })
+    );
+  }
+}
 
 /******************************************************************************/
 
 void LaBGen::insert(const Mat& current_frame) {
-  /* Background subtraction. */
-  bgs->process(current_frame.clone(), segmentation_map, mat_for_bgs_lib);
+  if (pipelined) {
+    insert_pipelined(current_frame);
+    return;
+  }
+
+  /*
+   * Background subtraction straight into the segmentation map. As before, the
+   * frames for which no mask is produced yet (e.g. the learning frames of KDE)
+   * are inserted along with the previous content of the map.
+   */
+  bgs->processMask(current_frame, segmentation_map);
 
   /* Initialization of background subtraction. */
   if (first_frame) {
@@ -68,26 +128,53 @@ void LaBGen::insert(const Mat& current_frame) {
     return;
   }
 
-  /* Ensure that the segmentation map has 1 channel. */
-  if (segmentation_map.channels() != 1)
-    cvtColor(segmentation_map, segmentation_map, CV_BGR2GRAY);
-
   /* Insert the current frame along with the segmentation map into the
    * history.
    */
-  history.insert(segmentation_map, current_frame);
+  history->insert(segmentation_map, current_frame);
 }
 
 /******************************************************************************/
 
-void LaBGen::generate_background(Mat& background) const {
-  if (history.empty()) {
+void LaBGen::insert_pipelined(const Mat& current_frame) {
+  /* Wait for a slot released by the insertion stage. */
+  size_t slot = pipeline->acquire();
+  Mat& frame = frames_slots[slot];
+  Mat& slot_segmentation_map = segmentation_slots[slot];
+
+  /* Background subtraction on the copy owned by the slot. */
+  current_frame.copyTo(frame);
+  bgs->processMask(frame, slot_segmentation_map);
+  current_slot = slot;
+
+  /* Initialization of background subtraction. */
+  if (first_frame) {
+    first_frame = false;
+    pipeline->release(slot);
+
+    return;
+  }
+
+  /* The insertion into the history is left to the pipeline. */
+  pipeline->submit(slot);
+}
+
+/******************************************************************************/
+
+void LaBGen::generate_background(Mat& background) {
+  /* Wait for the frames still in the pipeline. */
+  if (pipelined)
+    pipeline->wait();
+
+  if (history->empty()) {
     throw runtime_error(
       "Cannot generate the background with less than two inserted frames"
     );
   }
 
-  history.median(background, s);
+  /* Only the patches that changed since the last call are recomputed. */
+  history->refresh(cached_background, s);
+  cached_background.copyTo(background);
 }
 
 /******************************************************************************/
@@ -128,6 +215,33 @@ int32_t LaBGen::get_p() const {
 
 /******************************************************************************/
 
+bool LaBGen::is_incremental() const {
+  return incremental;
+}
+
+/******************************************************************************/
+
+int32_t LaBGen::get_threads() const {
+  return threads;
+}
+
+/******************************************************************************/
+
+bool LaBGen::is_pipelined() const {
+  return pipelined;
+}
+
+/******************************************************************************/
+
+uint32_t LaBGen::get_seed() const {
+  return seed;
+}
+
+/******************************************************************************/
+
 const Mat& LaBGen::get_segmentation_map() const {
+  if (pipelined)
+    return segmentation_slots[current_slot];
+
   return segmentation_map;
 }
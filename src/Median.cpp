@@ -0,0 +1,270 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <labgen/Median.hpp>
+
+using namespace std;
+using namespace ns_labgen::ns_internals;
+
+/* ========================================================================== *
+ * Median                                                                     *
+ * ========================================================================== */
+
+const size_t Median::SORTING_THRESHOLD = 24;
+
+/******************************************************************************/
+
+Median::Kernel Median::get_kernel(size_t size) {
+  return (size <= SORTING_THRESHOLD) ? &Median::sorting : &Median::counting;
+}
+
+/******************************************************************************/
+
+unsigned char Median::sorting(unsigned char* buffer, size_t size) {
+  for (size_t i = 1; i < size; ++i) {
+    unsigned char value = buffer[i];
+    size_t j = i;
+
+    for (; (j > 0) && (buffer[j - 1] > value); --j)
+      buffer[j] = buffer[j - 1];
+
+    buffer[j] = value;
+  }
+
+  size_t middle = size / 2;
+
+  if (size & 1)
+    return buffer[middle];
+
+  return ((static_cast<int32_t>(buffer[middle - 1])) + (buffer[middle])) / 2;
+}
+
+/******************************************************************************/
+
+unsigned char Median::counting(unsigned char* buffer, size_t size) {
+  size_t histogram[256];
+  memset(histogram, 0, sizeof(histogram));
+
+  for (size_t i = 0; i < size; ++i)
+    ++histogram[buffer[i]];
+
+  size_t middle = size / 2;
+  size_t rank = (size & 1) ? middle : (middle - 1);
+
+  /* Find the value of the sample of the given rank. */
+  size_t cumulative = 0;
+  int32_t lower = 0;
+
+  for (; (cumulative += histogram[lower]) <= rank; ++lower);
+
+  if ((size & 1) || (cumulative > middle))
+    return lower;
+
+  /* The following rank lies in the next non-empty bin. */
+  int32_t upper = lower + 1;
+
+  for (; histogram[upper] == 0; ++upper);
+
+  return (lower + upper) / 2;
+}
+
+/* ========================================================================== *
+ * Histograms kernels                                                         *
+ * ========================================================================== */
+
+namespace {
+  template <typename Counter>
+  void add_buffer(
+    Counter* coarse,
+    Counter* fine,
+    const unsigned char* buffer,
+    size_t size
+  ) {
+    for (size_t i = 0; i < size; ++i, coarse += 16, fine += 256) {
+      ++coarse[buffer[i] >> 4];
+      ++fine[buffer[i]];
+    }
+  }
+
+  /****************************************************************************/
+
+  template <typename Counter>
+  void remove_buffer(
+    Counter* coarse,
+    Counter* fine,
+    const unsigned char* buffer,
+    size_t size
+  ) {
+    for (size_t i = 0; i < size; ++i, coarse += 16, fine += 256) {
+      --coarse[buffer[i] >> 4];
+      --fine[buffer[i]];
+    }
+  }
+
+  /****************************************************************************/
+
+  template <typename Counter>
+  unsigned char select_rank(
+    const Counter* coarse,
+    const Counter* fine,
+    size_t rank
+  ) {
+    /* Coarse search. */
+    size_t cumulative = 0;
+    size_t bin = 0;
+
+    for (; cumulative + coarse[bin] <= rank; ++bin)
+      cumulative += coarse[bin];
+
+    /* Fine search. */
+    size_t value = bin << 4;
+
+    for (; (cumulative += fine[value]) <= rank; ++value);
+
+    return value;
+  }
+} /* anonymous */
+
+/* ========================================================================== *
+ * MedianHistograms                                                           *
+ * ========================================================================== */
+
+const size_t MedianHistograms::MAX_COUNT = UINT16_MAX;
+
+/******************************************************************************/
+
+MedianHistograms::MedianHistograms(size_t max_count) :
+samples(0),
+wide(max_count > UINT8_MAX),
+narrow_coarse(),
+narrow_fine(),
+wide_coarse(),
+wide_fine() {}
+
+/******************************************************************************/
+
+void MedianHistograms::resize(size_t samples) {
+  this->samples = samples;
+
+  if (wide) {
+    wide_coarse.assign(samples * 16, 0);
+    wide_fine.assign(samples * 256, 0);
+  }
+  else {
+    narrow_coarse.assign(samples * 16, 0);
+    narrow_fine.assign(samples * 256, 0);
+  }
+}
+
+/******************************************************************************/
+
+void MedianHistograms::add(const unsigned char* buffer, size_t size) {
+  if (samples == 0)
+    resize(size);
+  else if (size != samples)
+    throw logic_error("Cannot add a buffer of a different size");
+
+  if (wide)
+    add_buffer(wide_coarse.data(), wide_fine.data(), buffer, size);
+  else
+    add_buffer(narrow_coarse.data(), narrow_fine.data(), buffer, size);
+}
+
+/******************************************************************************/
+
+void MedianHistograms::remove(const unsigned char* buffer, size_t size) {
+  if (size != samples)
+    throw logic_error("Cannot remove a buffer of a different size");
+
+  if (wide)
+    remove_buffer(wide_coarse.data(), wide_fine.data(), buffer, size);
+  else
+    remove_buffer(narrow_coarse.data(), narrow_fine.data(), buffer, size);
+}
+
+/******************************************************************************/
+
+void MedianHistograms::add(size_t sample, unsigned char value) {
+  if (wide) {
+    ++wide_coarse[(sample * 16) + (value >> 4)];
+    ++wide_fine[(sample * 256) + value];
+  }
+  else {
+    ++narrow_coarse[(sample * 16) + (value >> 4)];
+    ++narrow_fine[(sample * 256) + value];
+  }
+}
+
+/******************************************************************************/
+
+void MedianHistograms::remove(size_t sample, unsigned char value) {
+  if (wide) {
+    --wide_coarse[(sample * 16) + (value >> 4)];
+    --wide_fine[(sample * 256) + value];
+  }
+  else {
+    --narrow_coarse[(sample * 16) + (value >> 4)];
+    --narrow_fine[(sample * 256) + value];
+  }
+}
+
+/******************************************************************************/
+
+void MedianHistograms::median(
+  unsigned char* result,
+  size_t count,
+  size_t first,
+  size_t length
+) const {
+  size_t middle = count / 2;
+
+  for (size_t i = 0; i < length; ++i) {
+    if (count & 1)
+      result[i] = select(first + i, middle);
+    else {
+      result[i] = (
+        (static_cast<int32_t>(select(first + i, middle - 1))) +
+        select(first + i, middle)
+      ) / 2;
+    }
+  }
+}
+
+/******************************************************************************/
+
+unsigned char MedianHistograms::select(size_t sample, size_t rank) const {
+  if (wide) {
+    return select_rank(
+      wide_coarse.data() + (sample * 16),
+      wide_fine.data() + (sample * 256),
+      rank
+    );
+  }
+
+  return select_rank(
+    narrow_coarse.data() + (sample * 16),
+    narrow_fine.data() + (sample * 256),
+    rank
+  );
+}
@@ -0,0 +1,152 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+
+#include <labgen/Pipeline.hpp>
+
+using namespace std;
+using namespace ns_labgen::ns_internals;
+
+/* ========================================================================== *
+ * Pipeline                                                                   *
+ * ========================================================================== */
+
+Pipeline::Pipeline(size_t depth, const Stage& stage) :
+stage(stage),
+free_slots(),
+queue(),
+busy(false),
+stopping(false),
+error(),
+mutex(),
+condition(),
+worker() {
+  if (depth == 0)
+    throw logic_error("The depth of the pipeline must be larger than 0");
+
+  free_slots.reserve(depth);
+
+  for (size_t i = 0; i < depth; ++i)
+    free_slots.push_back(depth - i - 1);
+
+  worker = thread(&Pipeline::work, this);
+}
+
+/******************************************************************************/
+
+Pipeline::~Pipeline() {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  condition.notify_all();
+  worker.join();
+}
+
+/******************************************************************************/
+
+size_t Pipeline::acquire() {
+  unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [this] { return !free_slots.empty() || error; });
+
+  if (error)
+    rethrow_exception(error);
+
+  size_t slot = free_slots.back();
+  free_slots.pop_back();
+
+  return slot;
+}
+
+/******************************************************************************/
+
+void Pipeline::release(size_t slot) {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    free_slots.push_back(slot);
+  }
+
+  condition.notify_all();
+}
+
+/******************************************************************************/
+
+void Pipeline::submit(size_t slot) {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    queue.push_back(slot);
+  }
+
+  condition.notify_all();
+}
+
+/******************************************************************************/
+
+void Pipeline::wait() const {
+  unique_lock<std::mutex> lock(mutex);
+  condition.wait(lock, [this] { return (queue.empty() && !busy) || error; });
+
+  if (error)
+    rethrow_exception(error);
+}
+
+/******************************************************************************/
+
+void Pipeline::work() {
+  for (;;) {
+    size_t slot;
+
+    {
+      unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this] { return stopping || !queue.empty(); });
+
+      /* Pending slots are processed before stopping. */
+      if (queue.empty())
+        return;
+
+      slot = queue.front();
+      queue.pop_front();
+      busy = true;
+    }
+
+    exception_ptr stage_error;
+
+    try {
+      stage(slot);
+    }
+    catch (...) {
+      stage_error = current_exception();
+    }
+
+    {
+      lock_guard<std::mutex> lock(mutex);
+
+      busy = false;
+      free_slots.push_back(slot);
+
+      if (stage_error && !error)
+        error = stage_error;
+    }
+
+    condition.notify_all();
+  }
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdexcept>
+
+#include <labgen/ThreadPool.hpp>
+
+using namespace std;
+using namespace ns_labgen::ns_internals;
+
+/* ========================================================================== *
+ * ThreadPool                                                                 *
+ * ========================================================================== */
+
+ThreadPool::ThreadPool(size_t threads) :
+threads(threads),
+workers(),
+ranges(new Range[threads]),
+mutex(),
+start_condition(),
+done_condition(),
+task(nullptr),
+generation(0),
+pending(0),
+stopping(false),
+error() {
+  if (threads == 0)
+    throw logic_error("The number of threads must be larger than 0");
+
+  workers.reserve(threads - 1);
+
+  for (size_t i = 1; i < threads; ++i)
+    workers.push_back(thread(&ThreadPool::work, this, i));
+}
+
+/******************************************************************************/
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  start_condition.notify_all();
+
+  for (thread& worker : workers)
+    worker.join();
+}
+
+/******************************************************************************/
+
+size_t ThreadPool::size() const {
+  return threads;
+}
+
+/******************************************************************************/
+
+void ThreadPool::parallel_for(size_t count, const Task& task) {
+  if ((threads == 1) || (count < 2)) {
+    for (size_t i = 0; i < count; ++i)
+      task(i);
+
+    return;
+  }
+
+  for (size_t i = 0; i < threads; ++i) {
+    ranges[i].next = (i * count) / threads;
+    ranges[i].end = ((i + 1) * count) / threads;
+  }
+
+  {
+    lock_guard<std::mutex> lock(mutex);
+
+    this->task = &task;
+    ++generation;
+    pending = threads - 1;
+    error = nullptr;
+  }
+
+  start_condition.notify_all();
+  run(0);
+
+  unique_lock<std::mutex> lock(mutex);
+  done_condition.wait(lock, [this] { return pending == 0; });
+
+  this->task = nullptr;
+
+  if (error)
+    rethrow_exception(error);
+}
+
+/******************************************************************************/
+
+void ThreadPool::work(size_t worker) {
+  size_t last_generation = 0;
+
+  for (;;) {
+    {
+      unique_lock<std::mutex> lock(mutex);
+
+      start_condition.wait(
+        lock,
+        [this, last_generation] {
+          return stopping || (generation != last_generation);
+        }
+      );
+
+      if (stopping)
+        return;
+
+      last_generation = generation;
+    }
+
+    run(worker);
+
+    {
+      lock_guard<std::mutex> lock(mutex);
+
+      if (--pending == 0)
+        done_condition.notify_one();
+    }
+  }
+}
+
+/******************************************************************************/
+
+void ThreadPool::run(size_t worker) {
+  /* Own range first, then the ranges of the other workers. */
+  for (size_t offset = 0; offset < threads; ++offset) {
+    Range& range = ranges[(worker + offset) % threads];
+
+    for (;;) {
+      size_t i = range.next.fetch_add(1);
+
+      if (i >= range.end)
+        break;
+
+      try {
+        (*task)(i);
+      }
+      catch (...) {
+        lock_guard<std::mutex> lock(mutex);
+
+        if (!error)
+          error = current_exception();
+      }
+    }
+  }
+}
@@ -0,0 +1,211 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+#include "dp/GrimsonGMM.h"
+
+using namespace std;
+using namespace Algorithms::BackgroundSubtraction;
+
+/* ========================================================================== *
+ * GrimsonGMMProbe                                                            *
+ * ========================================================================== */
+
+/* Gives access to the per-pixel reference and to the state of the model. */
+class GrimsonGMMProbe : public GrimsonGMM {
+  public:
+
+    /* Same as Subtract, but with SubtractPixel only. */
+    void SubtractScalar(
+      const RgbImage& data,
+      BwImage& low_threshold_mask,
+      BwImage& high_threshold_mask
+    ) {
+      for (unsigned int r = 0; r < m_params.Height(); ++r) {
+        for (unsigned int c = 0; c < m_params.Width(); ++c) {
+          SubtractPixel(
+            r * m_params.Width() + c,
+            data(r, c),
+            m_modes_per_pixel(r, c),
+            low_threshold_mask(r, c),
+            high_threshold_mask(r, c)
+          );
+        }
+      }
+    }
+
+    /* Compares the planes of the parameters and the number of modes. */
+    bool SameModel(GrimsonGMMProbe& other) {
+      size_t values = static_cast<size_t>(m_params.Size()) * m_params.MaxModes();
+      const float* planes[] = {
+        m_weight, m_var, m_muR, m_muG, m_muB, m_significants
+      };
+      const float* other_planes[] = {
+        other.m_weight, other.m_var, other.m_muR, other.m_muG, other.m_muB,
+        other.m_significants
+      };
+
+      for (size_t i = 0; i < 6; ++i) {
+        if (memcmp(planes[i], other_planes[i], values * sizeof(float)) != 0)
+          return false;
+      }
+
+      for (unsigned int r = 0; r < m_params.Height(); ++r) {
+        for (unsigned int c = 0; c < m_params.Width(); ++c) {
+          if (m_modes_per_pixel(r, c) != other.m_modes_per_pixel(r, c))
+            return false;
+        }
+      }
+
+      return true;
+    }
+};
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+/*
+ * Each pixel alternates between a few colors with a small noise, and
+ * sometimes takes a random color, so that modes are created, matched,
+ * replaced and sorted.
+ */
+static void fill_frame(RgbImage& frame, mt19937& rng, int32_t index) {
+  uniform_int_distribution<int> byte(0, 255);
+  uniform_int_distribution<int> noise(-4, 4);
+  uniform_int_distribution<int> percent(0, 99);
+
+  for (int r = 0; r < frame.Ptr()->height; ++r) {
+    for (int c = 0; c < frame.Ptr()->width; ++c) {
+      int32_t color = ((r * 7 + c * 3 + index / 5) % 3) * 80 + 20;
+      bool random = percent(rng) < 10;
+
+      for (int ch = 0; ch < 3; ++ch) {
+        int value = random ? byte(rng) : (color + ch * 10 + noise(rng));
+        frame(r, c, ch) = static_cast<unsigned char>(
+          (value < 0) ? 0 : (value > 255) ? 255 : value
+        );
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+static bool same_mask(BwImage& lhs, BwImage& rhs) {
+  for (int r = 0; r < lhs.Ptr()->height; ++r) {
+    for (int c = 0; c < lhs.Ptr()->width; ++c) {
+      if (lhs(r, c) != rhs(r, c))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************/
+
+/*
+ * Runs Subtract, which evaluates 4 pixels at once with SSE2 whenever
+ * alpha <= 1, and the per-pixel reference on the same frames.
+ */
+static bool check(int32_t modes, float alpha, int32_t width, mt19937& rng) {
+  static const int32_t HEIGHT = 3;
+  static const int32_t FRAMES = 60;
+
+  GrimsonParams params;
+  params.SetFrameSize(width, HEIGHT);
+  params.LowThreshold() = 3.0f * 3.0f;
+  params.HighThreshold() = 2 * params.LowThreshold();
+  params.Alpha() = alpha;
+  params.MaxModes() = modes;
+
+  RgbImage frame = cvCreateImage(cvSize(width, HEIGHT), IPL_DEPTH_8U, 3);
+  BwImage low = cvCreateImage(cvSize(width, HEIGHT), IPL_DEPTH_8U, 1);
+  BwImage high = cvCreateImage(cvSize(width, HEIGHT), IPL_DEPTH_8U, 1);
+  BwImage ref_low = cvCreateImage(cvSize(width, HEIGHT), IPL_DEPTH_8U, 1);
+  BwImage ref_high = cvCreateImage(cvSize(width, HEIGHT), IPL_DEPTH_8U, 1);
+
+  GrimsonGMMProbe vectorized;
+  GrimsonGMMProbe reference;
+  fill_frame(frame, rng, 0);
+  vectorized.Initalize(params);
+  vectorized.InitModel(frame);
+  reference.Initalize(params);
+  reference.InitModel(frame);
+
+  for (int32_t index = 0; index < FRAMES; ++index) {
+    fill_frame(frame, rng, index);
+
+    vectorized.Subtract(index, frame, low, high);
+    reference.SubtractScalar(frame, ref_low, ref_high);
+
+    const char* error = nullptr;
+
+    if (!vectorized.SameModel(reference))
+      error = "model";
+    else if (!same_mask(low, ref_low))
+      error = "low threshold mask";
+    else if (!same_mask(high, ref_high))
+      error = "high threshold mask";
+
+    if (error != nullptr) {
+      cerr << "The " << error << " differs (modes = " << modes
+           << ", alpha = " << alpha << ", width = " << width
+           << ", frame = " << index << ")" << endl;
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+  size_t failures = 0;
+
+  for (int32_t modes = 1; modes <= 5; ++modes) {
+    for (float alpha : {0.001f, 0.01f, 0.05f, 0.3f, 1.0f}) {
+      /* The widths which are not a multiple of 4 leave a scalar tail. */
+      for (int32_t width : {4, 5, 6, 7, 8, 13, 31}) {
+        if (!check(modes, alpha, width, rng))
+          ++failures;
+      }
+    }
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << "The vectorized GrimsonGMM matches SubtractPixel." << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "ae/NPBGSubtractor.h"
+
+using namespace std;
+
+/* ========================================================================== *
+ * Parameters                                                                 *
+ * ========================================================================== */
+
+/* Odd sizes, so that the bands have different heights. */
+const int32_t WIDTH = 41;
+const int32_t HEIGHT = 23;
+const int32_t CHANNELS = 3;
+
+/* Short window, so that the model is updated several times. */
+const int32_t SEQUENCE_LENGTH = 20;
+const int32_t TIME_WINDOW_SIZE = 40;
+const int32_t FRAMES_TO_LEARN = 20;
+const int32_t FRAMES = 80;
+
+/* Defaults of KDE. */
+const double TH = 10e-8;
+const double ALPHA = 0.3;
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+typedef vector<unsigned char> Frame;
+
+/*
+ * Synthetic sequence: a noisy gradient, crossed by a square whose color
+ * changes, with a few pixels that flicker.
+ */
+static vector<Frame> make_sequence(mt19937& rng) {
+  uniform_int_distribution<int> noise(-6, 6);
+  uniform_int_distribution<int> byte(0, 255);
+  bernoulli_distribution flicker(0.02);
+
+  vector<Frame> sequence(FRAMES_TO_LEARN + FRAMES,
+    Frame(WIDTH * HEIGHT * CHANNELS));
+
+  for (size_t t = 0; t < sequence.size(); ++t) {
+    int32_t square_x = static_cast<int32_t>(t * 2) % WIDTH;
+    int32_t square_y = static_cast<int32_t>(t) % HEIGHT;
+
+    for (int32_t r = 0; r < HEIGHT; ++r) {
+      for (int32_t c = 0; c < WIDTH; ++c) {
+        bool in_square = (t >= FRAMES_TO_LEARN) &&
+          (c >= square_x) && (c < square_x + 8) &&
+          (r >= square_y) && (r < square_y + 6);
+
+        for (int32_t ch = 0; ch < CHANNELS; ++ch) {
+          int value = 40 + 4 * c + 3 * r + 30 * ch + noise(rng);
+
+          if (in_square)
+            value = 200 - 60 * ch + static_cast<int>(t % 5) * 10;
+          else if (flicker(rng))
+            value = byte(rng);
+
+          sequence[t][(r * WIDTH + c) * CHANNELS + ch] =
+            static_cast<unsigned char>(min(max(value, 0), 255));
+        }
+      }
+    }
+  }
+
+  return sequence;
+}
+
+/******************************************************************************/
+
+/*
+ * Runs KDE as the KDE class does, and returns the masks of all the frames
+ * following the learning ones.
+ */
+static vector<Frame> run(const vector<Frame>& sequence, unsigned int threads,
+  bool color_ratios, bool pixel_major) {
+  NPBGSubtractor subtractor(threads);
+
+  subtractor.Intialize(HEIGHT, WIDTH, CHANNELS, SEQUENCE_LENGTH,
+    TIME_WINDOW_SIZE, 1, color_ratios, pixel_major);
+  subtractor.SetThresholds(TH, ALPHA);
+
+  for (int32_t t = 0; t < FRAMES_TO_LEARN; ++t) {
+    /* AddFrame converts the frame in place, so it works on a copy. */
+    Frame learning = sequence[t];
+    subtractor.AddFrame(learning.data());
+  }
+
+  subtractor.Estimation();
+
+  vector<Frame> masks;
+
+  for (int32_t t = FRAMES_TO_LEARN; t < FRAMES_TO_LEARN + FRAMES; ++t) {
+    Frame frame = sequence[t];
+    Frame mask(WIDTH * HEIGHT);
+
+    subtractor.NBBGSubtraction(frame.data(), mask.data(), 0, 0);
+    subtractor.Update(mask.data());
+    masks.push_back(mask);
+  }
+
+  return masks;
+}
+
+/******************************************************************************/
+
+/* Compares two runs frame by frame, and reports the first difference. */
+static bool same_masks(const vector<Frame>& masks,
+  const vector<Frame>& expected, const char* what, bool color_ratios,
+  bool pixel_major) {
+  for (size_t t = 0; t < expected.size(); ++t) {
+    if (masks[t] != expected[t]) {
+      cerr << what << ": mask " << t << " differs (color ratios = "
+           << color_ratios << ", pixel-major = " << pixel_major << ")"
+           << endl;
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+  vector<Frame> sequence = make_sequence(rng);
+  size_t failures = 0;
+
+  for (bool color_ratios : {false, true}) {
+    vector<Frame> frame_major = run(sequence, 1, color_ratios, false);
+
+    for (bool pixel_major : {false, true}) {
+      vector<Frame> serial = run(sequence, 1, color_ratios, pixel_major);
+
+      /* The layout of the samples does not change the masks. */
+      if (pixel_major && !same_masks(serial, frame_major, "Layout",
+        color_ratios, pixel_major))
+        ++failures;
+
+      /* The bands of rows do not change the masks. */
+      for (unsigned int threads : {2, 3, 4}) {
+        if (!same_masks(run(sequence, threads, color_ratios, pixel_major),
+          serial, "Threads", color_ratios, pixel_major))
+          ++failures;
+      }
+    }
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << "The KDE masks do not depend on the sample layout nor on the "
+       << "number of threads." << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/* The kernel sums are internal to the library, hence the direct inclusion. */
+#include "ae/NPBGSubtractor.cpp"
+
+using namespace std;
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+/* Kernels of the samples of a pixel, read from an array. */
+struct ArrayKernel {
+  const float* values;
+
+  float operator()(unsigned int j) const {
+    return values[j];
+  }
+};
+
+/******************************************************************************/
+
+/*
+ * Fills the kernels of a pixel around a mean close to threshold, so that
+ * many pixels are near the decision, with some zeros as for the samples
+ * out of the brightness range.
+ */
+static void fill_kernels(vector<float>& values, double threshold,
+  mt19937& rng) {
+  uniform_real_distribution<double> exponent(-2, 2);
+  uniform_real_distribution<double> unit(0, 2);
+  bernoulli_distribution zero(0.2);
+
+  double scale = threshold * pow(10, exponent(rng));
+
+  for (float& value : values)
+    value = zero(rng) ? 0 : static_cast<float>(scale * unit(rng));
+}
+
+/******************************************************************************/
+
+/*
+ * Probability of a pixel with the early exit checked after each sample, in
+ * double precision.
+ */
+static double reference_probability(const vector<float>& values,
+  double th) {
+  double sum = 0;
+  size_t j = 0;
+
+  while ((j < values.size()) && (sum < th))
+    sum += values[j++];
+
+  return sum / j;
+}
+
+/******************************************************************************/
+
+/*
+ * Sums of the SSE2 path compared to the ones of the NPBG_NO_SIMD path, which
+ * must be identical, and masks compared to the ones of the early exit
+ * checked after each sample, which can only differ near the threshold.
+ */
+static bool check(unsigned int sample_size, double threshold, mt19937& rng) {
+  const size_t PIXELS = 2000;
+  const double th = threshold * sample_size;
+
+  vector<float> values(sample_size);
+  ArrayKernel kernel = {values.data()};
+
+  for (size_t pixel = 0; pixel < PIXELS; ++pixel) {
+    fill_kernels(values, threshold, rng);
+
+    unsigned int j;
+    float sum = SumKernelsScalar(kernel, sample_size, th, j);
+
+#ifdef NPBG_SSE2
+    unsigned int simd_j;
+    float simd_sum = SumKernelsSSE2(kernel, sample_size, th, simd_j);
+
+    if ((memcmp(&simd_sum, &sum, sizeof(sum)) != 0) || (simd_j != j)) {
+      cerr << "SSE2 sum " << simd_sum << " of " << simd_j
+           << " samples instead of " << sum << " of " << j
+           << " (sample size = " << sample_size << ", threshold = "
+           << threshold << ")" << endl;
+
+      return false;
+    }
+#endif
+
+    double p = static_cast<double>(sum) / j;
+    double expected = reference_probability(values, th);
+
+    if ((p > threshold) != (expected > threshold)) {
+      double distance = min(fabs(p - threshold), fabs(expected - threshold));
+
+      if (distance > 1e-5 * threshold) {
+        cerr << "Probability " << p << " instead of " << expected
+             << " on the other side of the threshold (sample size = "
+             << sample_size << ", threshold = " << threshold << ")" << endl;
+
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+  size_t failures = 0;
+
+  /* Sample sizes around the block size exercise the partial blocks. */
+  for (unsigned int sample_size = 1; sample_size <= 64; ++sample_size) {
+    for (double threshold : {10e-8, 1e-4, 1e-2, 0.1}) {
+      if (!check(sample_size, threshold, rng))
+        ++failures;
+    }
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+#ifdef NPBG_SSE2
+  cout << "The SSE2 kernel sums match the NPBG_NO_SIMD ones." << endl;
+#else
+  cout << "The kernel sums match the reference (SSE2 not available)." << endl;
+#endif
+
+  return EXIT_SUCCESS;
+}
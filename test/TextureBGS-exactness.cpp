@@ -0,0 +1,212 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+/* The texture kernels are internal to the library, hence the direct inclusion. */
+#include "dp/TextureBGS.cpp"
+
+using namespace std;
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+/*
+ * Fills an image with values either spread over the whole range, or close
+ * to each other (so that the hysteresis decides), or close to 255 (so that
+ * the saturation of center + HYSTERSIS matters).
+ */
+static void fill_image(RgbImage& image, mt19937& rng, int32_t kind) {
+  uniform_int_distribution<int> byte(0, 255);
+  uniform_int_distribution<int> close(-HYSTERSIS - 2, HYSTERSIS + 2);
+
+  int center = (kind == 2) ? 252 : byte(rng);
+
+  for (int r = 0; r < image.Ptr()->height; ++r) {
+    for (int c = 0; c < image.Ptr()->width; ++c) {
+      for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+        int value = (kind == 0) ? byte(rng) : (center + close(rng));
+        image(r, c, ch) = static_cast<unsigned char>(
+          (value < 0) ? 0 : (value > 255) ? 255 : value
+        );
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+/* Texture codes computed one byte at a time with TextureCode. */
+static bool check_lbp(TextureBGS& bgs, int32_t width, int32_t height,
+  mt19937& rng) {
+  RgbImage image = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 3);
+  RgbImage texture = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 3);
+
+  for (int32_t kind = 0; kind < 3; ++kind) {
+    fill_image(image, rng, kind);
+    cvZero(texture.Ptr());
+    bgs.LBP(image, texture);
+
+    for (int y = TEXTURE_R; y < height - TEXTURE_R; ++y) {
+      const unsigned char* center = &image(y, 0, 0);
+      const unsigned char* codes = &texture(y, 0, 0);
+
+      for (int k = TEXTURE_R * NUM_CHANNELS;
+        k < (width - TEXTURE_R) * NUM_CHANNELS; ++k) {
+        unsigned char expected = TextureCode(&image(y - 2, 0, 0),
+          &image(y - 1, 0, 0), center, &image(y + 1, 0, 0),
+          &image(y + 2, 0, 0), k);
+
+        if (codes[k] != expected) {
+          cerr << "LBP: byte " << k << " of row " << y << " is "
+               << static_cast<int>(codes[k]) << " instead of "
+               << static_cast<int>(expected) << " (width = " << width
+               << ", height = " << height << ")" << endl;
+
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************/
+
+/*
+ * Histograms of the sliding square compared to the ones computed from
+ * scratch, and intersections of consecutive histograms compared to the
+ * scalar sum of the minimums.
+ */
+static bool check_histograms(TextureBGS& bgs, int32_t width, int32_t height,
+  mt19937& rng) {
+  uniform_int_distribution<int> code(0, NUM_BINS - 1);
+  RgbImage texture = cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 3);
+
+  for (int r = 0; r < height; ++r) {
+    for (int c = 0; c < width; ++c) {
+      for (int ch = 0; ch < NUM_CHANNELS; ++ch)
+        texture(r, c, ch) = static_cast<unsigned char>(code(rng));
+    }
+  }
+
+  const int first = REGION_R + TEXTURE_R;
+  size_t visited = 0;
+  bool success = true;
+  TextureHistogram previous;
+  memset(&previous, 0, sizeof(previous));
+
+  SlideHistograms(texture, [&](int y, int x, const TextureHistogram& hist) {
+    ++visited;
+
+    if (!success)
+      return;
+
+    TextureHistogram expected;
+    memset(&expected, 0, sizeof(expected));
+
+    for (int j = -REGION_R; j <= REGION_R; ++j) {
+      for (int i = -REGION_R; i <= REGION_R; ++i) {
+        expected.r[texture(y + j, x + i, 2)]++;
+        expected.g[texture(y + j, x + i, 1)]++;
+        expected.b[texture(y + j, x + i, 0)]++;
+      }
+    }
+
+    if (memcmp(&hist, &expected, sizeof(expected)) != 0) {
+      cerr << "Histogram of (" << y << ", " << x << ") differs (width = "
+           << width << ", height = " << height << ")" << endl;
+
+      success = false;
+      return;
+    }
+
+    int proximity = 0;
+
+    for (int i = 0; i < NUM_BINS; ++i) {
+      proximity += min(previous.r[i], hist.r[i]);
+      proximity += min(previous.g[i], hist.g[i]);
+      proximity += min(previous.b[i], hist.b[i]);
+    }
+
+    if (bgs.ProximityMeasure(previous, hist) != proximity) {
+      cerr << "Proximity of (" << y << ", " << x << ") differs (width = "
+           << width << ", height = " << height << ")" << endl;
+
+      success = false;
+    }
+
+    previous = hist;
+  });
+
+  /* Every pixel far enough from the borders is visited once. */
+  size_t expected_visits = 0;
+
+  if ((width > 2 * first) && (height > 2 * first))
+    expected_visits = size_t(width - 2 * first) * (height - 2 * first);
+
+  if (success && (visited != expected_visits)) {
+    cerr << visited << " histograms instead of " << expected_visits
+         << " (width = " << width << ", height = " << height << ")" << endl;
+
+    success = false;
+  }
+
+  return success;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+  TextureBGS bgs;
+  size_t failures = 0;
+
+  /* Odd widths and widths around the vector size exercise the tails. */
+  for (int32_t width = 5; width <= 40; ++width) {
+    for (int32_t height : {5, 6, 9}) {
+      if (!check_lbp(bgs, width, height, rng))
+        ++failures;
+    }
+  }
+
+  for (int32_t width : {13, 14, 15, 17, 23, 31, 64}) {
+    for (int32_t height : {13, 15, 20}) {
+      if (!check_histograms(bgs, width, height, rng))
+        ++failures;
+    }
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << "The texture codes and histograms match the references." << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+/* The fixed-point helpers are internal to the library, hence the inclusion. */
+#include "dp/WrenGAFixed.cpp"
+
+using namespace std;
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+/*
+ * Each pixel is a noisy gradient, crossed by a moving square, so that the
+ * means follow the noise and some pixels are masked out of the update.
+ */
+static void fill_frame(RgbImage& frame, mt19937& rng, int32_t index) {
+  uniform_int_distribution<int> noise(-8, 8);
+
+  for (int r = 0; r < frame.Ptr()->height; ++r) {
+    for (int c = 0; c < frame.Ptr()->width; ++c) {
+      bool in_square = (index > 0) &&
+        (abs(c - (index % frame.Ptr()->width)) < 4) && (r % 8 < 4);
+
+      for (int ch = 0; ch < 3; ++ch) {
+        int value = in_square ? 250 - 100 * ch :
+          (20 + 5 * c + 3 * r + 40 * ch + noise(rng));
+        frame(r, c, ch) = static_cast<unsigned char>(
+          (value < 0) ? 0 : (value > 255) ? 255 : value
+        );
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+/* The fixed-point steps are rounded to the nearest representable value. */
+static bool check_rounding() {
+  for (int delta = -(255 << 8); delta <= (255 << 8); ++delta) {
+    long long expected = static_cast<long long>(
+      floor(static_cast<double>(delta) * delta / 256 + 0.5));
+
+    if (SquaredDistance(delta) != expected) {
+      cerr << "SquaredDistance(" << delta << ") is " << SquaredDistance(delta)
+           << " instead of " << expected << endl;
+
+      return false;
+    }
+  }
+
+  for (int alpha : {1, 328, 655, 3277, 19661, 65536}) {
+    for (int value = -(255 << 8); value <= (255 << 8); value += 7) {
+      long long expected = static_cast<long long>(
+        floor(static_cast<double>(alpha) * value / 65536 + 0.5));
+
+      if (ScaleByAlpha(alpha, value) != expected) {
+        cerr << "ScaleByAlpha(" << alpha << ", " << value << ") is "
+             << ScaleByAlpha(alpha, value) << " instead of " << expected
+             << endl;
+
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************/
+
+/*
+ * Runs WrenGA and WrenGAFixed on the same frames, both updated with the mask
+ * of WrenGA, and checks that the backgrounds differ by at most 1.
+ */
+static bool check_background(float alpha, mt19937& rng) {
+  static const int32_t WIDTH = 37;
+  static const int32_t HEIGHT = 16;
+  static const int32_t FRAMES = 2000;
+
+  WrenParams params;
+  params.SetFrameSize(WIDTH, HEIGHT);
+  params.LowThreshold() = 3.5f * 3.5f;
+  params.HighThreshold() = 2 * params.LowThreshold();
+  params.Alpha() = alpha;
+  /* The first update covers every pixel, so that the backgrounds are set. */
+  params.LearningFrames() = 1;
+
+  RgbImage frame = cvCreateImage(cvSize(WIDTH, HEIGHT), IPL_DEPTH_8U, 3);
+  BwImage low = cvCreateImage(cvSize(WIDTH, HEIGHT), IPL_DEPTH_8U, 1);
+  BwImage high = cvCreateImage(cvSize(WIDTH, HEIGHT), IPL_DEPTH_8U, 1);
+  BwImage fixed_low = cvCreateImage(cvSize(WIDTH, HEIGHT), IPL_DEPTH_8U, 1);
+  BwImage fixed_high = cvCreateImage(cvSize(WIDTH, HEIGHT), IPL_DEPTH_8U, 1);
+
+  WrenGA reference;
+  WrenGAFixed fixed;
+  fill_frame(frame, rng, 0);
+  reference.Initalize(params);
+  reference.InitModel(frame);
+  fixed.Initalize(params);
+  fixed.InitModel(frame);
+
+  for (int32_t index = 0; index < FRAMES; ++index) {
+    fill_frame(frame, rng, index);
+
+    reference.Subtract(index, frame, low, high);
+    fixed.Subtract(index, frame, fixed_low, fixed_high);
+    reference.Update(index, frame, low);
+    fixed.Update(index, frame, low);
+
+    RgbImage& expected = *reference.Background();
+    RgbImage& background = *fixed.Background();
+
+    for (int r = 0; r < HEIGHT; ++r) {
+      for (int c = 0; c < WIDTH; ++c) {
+        for (int ch = 0; ch < 3; ++ch) {
+          if (abs(background(r, c, ch) - expected(r, c, ch)) > 1) {
+            cerr << "Background " << static_cast<int>(background(r, c, ch))
+                 << " instead of " << static_cast<int>(expected(r, c, ch))
+                 << " at (" << r << ", " << c << ", " << ch << ") (alpha = "
+                 << alpha << ", frame = " << index << ")" << endl;
+
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+  size_t failures = 0;
+
+  if (!check_rounding())
+    ++failures;
+
+  /*
+   * The bound holds while the dead zone 128/a of the means is below half a
+   * gray level, that is from alpha = 1/256 on, which includes the default.
+   */
+  for (float alpha : {0.005f, 0.01f, 0.05f, 0.3f, 1.0f}) {
+    if (!check_background(alpha, rng))
+      ++failures;
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << "The fixed-point background is within 1 of the float one." << endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "dp/ZivkovicAGMM.h"
+
+using namespace std;
+using namespace Algorithms::BackgroundSubtraction;
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+/*
+ * Each pixel alternates between a few colors with a small noise, and
+ * sometimes takes a random color, so that modes are created, matched,
+ * replaced and sorted.
+ */
+static void fill_frame(RgbImage& frame, mt19937& rng, int32_t index) {
+  uniform_int_distribution<int> byte(0, 255);
+  uniform_int_distribution<int> noise(-4, 4);
+  uniform_int_distribution<int> percent(0, 99);
+
+  for (int r = 0; r < frame.Ptr()->height; ++r) {
+    for (int c = 0; c < frame.Ptr()->width; ++c) {
+      int32_t color = ((r * 7 + c * 3 + index / 5) % 3) * 80 + 20;
+      bool random = percent(rng) < 10;
+
+      for (int ch = 0; ch < 3; ++ch) {
+        int value = random ? byte(rng) : (color + ch * 10 + noise(rng));
+        frame(r, c, ch) = static_cast<unsigned char>(
+          (value < 0) ? 0 : (value > 255) ? 255 : value
+        );
+      }
+    }
+  }
+}
+
+/******************************************************************************/
+
+template <class Image>
+static bool same_image(Image& lhs, Image& rhs, int channels) {
+  for (int r = 0; r < lhs.Ptr()->height; ++r) {
+    for (int c = 0; c < lhs.Ptr()->width; ++c) {
+      for (int ch = 0; ch < channels; ++ch) {
+        const unsigned char* left =
+          reinterpret_cast<const unsigned char*>(lhs.Ptr()->imageData);
+        const unsigned char* right =
+          reinterpret_cast<const unsigned char*>(rhs.Ptr()->imageData);
+        int i = r * lhs.Ptr()->widthStep + c * channels + ch;
+
+        if (left[i] != right[i])
+          return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************/
+
+/*
+ * Runs a single thread and several ones on the same frames, which must give
+ * the same masks and backgrounds whatever the bands of rows.
+ */
+static bool check(int32_t modes, size_t threads, int32_t height,
+  mt19937& rng) {
+  static const int32_t WIDTH = 19;
+  static const int32_t FRAMES = 60;
+
+  ZivkovicParams params;
+  params.SetFrameSize(WIDTH, height);
+  params.LowThreshold() = 5.0f * 5.0f;
+  params.HighThreshold() = 2 * params.LowThreshold();
+  params.Alpha() = 0.01f;
+  params.MaxModes() = modes;
+
+  RgbImage frame = cvCreateImage(cvSize(WIDTH, height), IPL_DEPTH_8U, 3);
+  BwImage low = cvCreateImage(cvSize(WIDTH, height), IPL_DEPTH_8U, 1);
+  BwImage high = cvCreateImage(cvSize(WIDTH, height), IPL_DEPTH_8U, 1);
+  BwImage ref_low = cvCreateImage(cvSize(WIDTH, height), IPL_DEPTH_8U, 1);
+  BwImage ref_high = cvCreateImage(cvSize(WIDTH, height), IPL_DEPTH_8U, 1);
+
+  ZivkovicAGMM parallel(threads);
+  ZivkovicAGMM serial(1);
+  fill_frame(frame, rng, 0);
+  parallel.Initalize(params);
+  parallel.InitModel(frame);
+  serial.Initalize(params);
+  serial.InitModel(frame);
+
+  for (int32_t index = 0; index < FRAMES; ++index) {
+    fill_frame(frame, rng, index);
+
+    parallel.Subtract(index, frame, low, high);
+    serial.Subtract(index, frame, ref_low, ref_high);
+
+    const char* error = nullptr;
+
+    if (!same_image(low, ref_low, 1))
+      error = "low threshold mask";
+    else if (!same_image(high, ref_high, 1))
+      error = "high threshold mask";
+    else if (!same_image(*parallel.Background(), *serial.Background(), 3))
+      error = "background";
+
+    if (error != nullptr) {
+      cerr << "The " << error << " differs (modes = " << modes
+           << ", threads = " << threads << ", height = " << height
+           << ", frame = " << index << ")" << endl;
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+  size_t failures = 0;
+
+  for (int32_t modes : {1, 3, 5}) {
+    for (size_t threads : {2, 3, 4}) {
+      /* Fewer rows than bands, and rows not divisible by the bands. */
+      for (int32_t height : {1, 5, 23}) {
+        if (!check(modes, threads, height, rng))
+          ++failures;
+      }
+    }
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << "The Zivkovic AGMM does not depend on the number of threads."
+       << endl;
+  return EXIT_SUCCESS;
+}
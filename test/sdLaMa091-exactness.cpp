@@ -0,0 +1,294 @@
+/**
+ * Copyright - Benjamin Laugraud <blaugraud@ulg.ac.be> - 2017
+ * http://www.montefiore.ulg.ac.be/~blaugraud
+ * http://www.telecom.ulg.ac.be/labgen
+ *
+ * This file is part of LaBGen.
+ *
+ * LaBGen is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * LaBGen is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with LaBGen.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/* The row kernels are internal to the library, hence the direct inclusion. */
+#include "bl/sdLaMa091.cpp"
+
+using namespace std;
+
+typedef vector<uint8_t>                                                Bytes;
+
+/* ========================================================================== *
+ * Helpers                                                                    *
+ * ========================================================================== */
+
+/*
+ * Fills a row with uniform noise, or with small deviations around a value so
+ * that Mt converges and Vt moves in both directions.
+ */
+static void fill_row(Bytes& row, mt19937& rng, bool noisy) {
+  uniform_int_distribution<int> byte(0, 255);
+
+  if (noisy) {
+    for (size_t j = 0; j < row.size(); ++j)
+      row[j] = static_cast<uint8_t>(byte(rng));
+  }
+  else {
+    uniform_int_distribution<int> deviation(-3, 3);
+    int center = byte(rng);
+
+    for (size_t j = 0; j < row.size(); ++j) {
+      int value = center + deviation(rng);
+      row[j] = static_cast<uint8_t>((value < 0) ? 0 : (value > 255) ? 255 :
+        value);
+    }
+  }
+}
+
+/******************************************************************************/
+
+/*
+ * Runs a kernel and the scalar reference on the same random state for a few
+ * frames, and reports the first byte that differs.
+ */
+static bool check_kernel(
+  const string& name,
+  updateRow_t kernel,
+  uint32_t N,
+  uint32_t Vmin,
+  uint32_t Vmax,
+  uint32_t width,
+  mt19937& rng
+) {
+  static const int32_t FRAMES = 24;
+
+  sdLaMa091_t params;
+  params.N = N;
+  params.Vmin = Vmin;
+  params.Vmax = Vmax;
+
+  /* Vt starts anywhere, 255 included, to exercise its wrap. */
+  Bytes image(width), Mt(width), Ot(width), Vt(width), labels(width);
+  fill_row(Mt, rng, true);
+  fill_row(Vt, rng, true);
+
+  for (uint32_t j = 0; j < width; j += 5)
+    Vt[j] = 255;
+
+  Bytes refMt(Mt), refOt(Ot), refVt(Vt), refLabels(labels);
+
+  for (int32_t frame = 0; frame < FRAMES; ++frame) {
+    fill_row(image, rng, (frame % 3) == 0);
+
+    updateRowScalar(&params, image.data(), refMt.data(), refOt.data(),
+      refVt.data(), refLabels.data(), width);
+    kernel(&params, image.data(), Mt.data(), Ot.data(), Vt.data(),
+      labels.data(), width);
+
+    const Bytes* got[] = {&Mt, &Ot, &Vt, &labels};
+    const Bytes* expected[] = {&refMt, &refOt, &refVt, &refLabels};
+    const char* tables[] = {"Mt", "Ot", "Vt", "labels"};
+
+    for (int32_t t = 0; t < 4; ++t) {
+      for (uint32_t j = 0; j < width; ++j) {
+        if ((*got[t])[j] != (*expected[t])[j]) {
+          cerr << name << ": " << tables[t] << "[" << j << "] is "
+               << static_cast<int>((*got[t])[j]) << " instead of "
+               << static_cast<int>((*expected[t])[j]) << " (N = " << N
+               << ", Vmin = " << Vmin << ", Vmax = " << Vmax
+               << ", width = " << width << ", frame = " << frame << ")"
+               << endl;
+
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************/
+
+/*
+ * Compares the C3R and C3C1R updates, which use the selected kernel and merge
+ * the labels of the channels, to the scalar reference followed by the merge.
+ * The single-channel map has padding bytes at the end of its rows, which must
+ * be left untouched.
+ */
+static bool check_merge(uint32_t N, uint32_t width, uint32_t padding,
+  mt19937& rng) {
+  static const uint8_t UNTOUCHED = 0x5a;
+
+  static const int32_t FRAMES = 8;
+  static const uint32_t HEIGHT = 3;
+
+  const uint32_t stride = width * CHANNELS + 7;
+  const uint32_t map_stride = width + padding;
+  Bytes image(stride * HEIGHT);
+  fill_row(image, rng, true);
+
+  sdLaMa091_t* c3r = sdLaMa091New();
+  sdLaMa091_t* c3c1r = sdLaMa091New();
+  sdLaMa091AllocInit_8u_C3R(c3r, image.data(), width, HEIGHT, stride);
+  sdLaMa091AllocInit_8u_C3R(c3c1r, image.data(), width, HEIGHT, stride);
+  sdLaMa091SetAmplificationFactor(c3r, N);
+  sdLaMa091SetAmplificationFactor(c3c1r, N);
+
+  /* Only the first width bytes of each row of Vt are initialized for C3R. */
+  memset(c3r->Vt, DEFAULT_VMIN, c3r->numBytes);
+  memset(c3c1r->Vt, DEFAULT_VMIN, c3c1r->numBytes);
+
+  sdLaMa091_t ref = *c3r;
+  Bytes refMt(c3r->Mt, c3r->Mt + c3r->numBytes);
+  Bytes refOt(c3r->Ot, c3r->Ot + c3r->numBytes);
+  Bytes refVt(c3r->Vt, c3r->Vt + c3r->numBytes);
+
+  Bytes map(stride * HEIGHT), refMap(stride * HEIGHT);
+  Bytes mono(map_stride * HEIGHT, UNTOUCHED);
+  bool success = true;
+
+  for (int32_t frame = 0; success && (frame < FRAMES); ++frame) {
+    fill_row(image, rng, (frame % 2) == 0);
+
+    sdLaMa091Update_8u_C3R(c3r, image.data(), map.data());
+    sdLaMa091Update_8u_C3C1R(c3c1r, image.data(), mono.data(), map_stride);
+
+    for (uint32_t i = 0; i < ref.numBytes; i += stride) {
+      uint8_t* labels = refMap.data() + i;
+
+      updateRowScalar(&ref, image.data() + i, refMt.data() + i,
+        refOt.data() + i, refVt.data() + i, labels, ref.rgbWidth);
+
+      for (uint32_t j = 0; j < ref.rgbWidth; j += CHANNELS) {
+        uint8_t label = labels[j + RED] | labels[j + GREEN] | labels[j + BLUE];
+
+        labels[j + RED] = label;
+        labels[j + GREEN] = label;
+        labels[j + BLUE] = label;
+      }
+    }
+
+    for (uint32_t y = 0; success && (y < HEIGHT); ++y) {
+      for (uint32_t j = 0; success && (j < ref.rgbWidth); ++j) {
+        uint32_t i = y * stride + j;
+
+        if (
+          (c3r->Mt[i] != refMt[i]) || (c3r->Vt[i] != refVt[i]) ||
+          (c3c1r->Vt[i] != refVt[i]) || (map[i] != refMap[i]) ||
+          (mono[y * map_stride + j / CHANNELS] != refMap[i])
+        ) {
+          cerr << "C3R merge: byte " << j << " of row " << y
+               << " differs (N = " << N << ", width = " << width
+               << ", padding = " << padding << ", frame = " << frame << ")"
+               << endl;
+
+          success = false;
+        }
+      }
+
+      for (uint32_t x = width; success && (x < map_stride); ++x) {
+        if (mono[y * map_stride + x] != UNTOUCHED) {
+          cerr << "C3C1R: padding byte " << x << " of row " << y
+               << " was written (N = " << N << ", width = " << width
+               << ", padding = " << padding << ", frame = " << frame << ")"
+               << endl;
+
+          success = false;
+        }
+      }
+    }
+  }
+
+  sdLaMa091Free(c3r);
+  sdLaMa091Free(c3c1r);
+
+  return success;
+}
+
+/* ========================================================================== *
+ * Main                                                                       *
+ * ========================================================================== */
+
+int main() {
+  mt19937 rng(20170418);
+
+  vector<pair<string, updateRow_t> > kernels;
+#ifdef SDLAMA091_SSE2
+  kernels.push_back(make_pair(string("SSE2"), updateRowSSE2));
+#endif
+#ifdef SDLAMA091_AVX2
+  if (__builtin_cpu_supports("avx2"))
+    kernels.push_back(make_pair(string("AVX2"), updateRowAVX2));
+  else
+    cout << "AVX2 is not supported by the CPU, skipping it." << endl;
+#endif
+
+  /* N = 0 and N >= 256 take the extreme paths of ampThreshold and ampFactor. */
+  const uint32_t factors[] = {
+    0, 1, 2, 3, 4, 7, 16, 17, 63, 85, 127, 128, 254, 255, 256, 257, 1000
+  };
+
+  /* Vmin and Vmax are truncated to 8 bits by every kernel (300 is 44). */
+  const uint32_t bounds[][2] = {{2, 255}, {0, 255}, {0, 0}, {50, 60}, {2, 300}};
+
+  /* Odd widths and widths around the vector sizes exercise the tails. */
+  vector<uint32_t> widths;
+
+  for (uint32_t width = 1; width <= 100; ++width)
+    widths.push_back(width);
+
+  widths.push_back(127);
+  widths.push_back(255);
+  widths.push_back(1001);
+
+  size_t failures = 0;
+
+  for (size_t k = 0; k < kernels.size(); ++k) {
+    for (uint32_t N : factors) {
+      for (const auto& bound : bounds) {
+        for (uint32_t width : widths) {
+          if (
+            !check_kernel(kernels[k].first, kernels[k].second, N, bound[0],
+              bound[1], width, rng)
+          ) {
+            ++failures;
+          }
+        }
+      }
+    }
+  }
+
+  for (uint32_t N : factors) {
+    for (uint32_t width : {1u, 5u, 11u, 21u, 43u, 333u}) {
+      /* A map wider than the frame, as for the rows of an aligned image. */
+      for (uint32_t padding : {0u, 3u, 16u}) {
+        if (!check_merge(N, width, padding, rng))
+          ++failures;
+      }
+    }
+  }
+
+  if (failures != 0) {
+    cerr << failures << " configuration(s) failed." << endl;
+    return EXIT_FAILURE;
+  }
+
+  cout << "All the kernels match the scalar reference." << endl;
+  return EXIT_SUCCESS;
+}